@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// Set of board squares, bit number is y * 8 + x
+typedef std::uint64_t Bitboard;
+
+/// Attack sets of figures, tables of non-sliding ones are generated at compile time
+namespace Attacks {
+
+constexpr int square(int x, int y)
+{
+    return y * 8 + x;
+}
+
+/// empty set for coordinates out of board
+constexpr Bitboard bit(int x, int y)
+{
+    return x >= 0 && x < 8 && y >= 0 && y < 8 ? Bitboard(1) << square(x, y) : 0;
+}
+
+template <std::size_t N>
+constexpr std::array<Bitboard, 64> buildTable(const int (&dx)[N], const int (&dy)[N])
+{
+    std::array<Bitboard, 64> table{};
+    for (int sq = 0; sq < 64; ++sq)
+        for (std::size_t i = 0; i < N; ++i)
+            table[sq] |= bit(sq % 8 + dx[i], sq / 8 + dy[i]);
+    return table;
+}
+
+constexpr int knightDx[] = {2, 2, -2, -2, 1, -1, 1, -1};
+constexpr int knightDy[] = {1, -1, 1, -1, 2, 2, -2, -2};
+constexpr int kingDx[] = {1, -1, 1, -1, -1, 1, 0, 0};
+constexpr int kingDy[] = {0, 0, 1, 1, -1, -1, 1, -1};
+constexpr int whitePawnDx[] = {1, -1};
+constexpr int whitePawnDy[] = {1, 1};
+constexpr int blackPawnDx[] = {1, -1};
+constexpr int blackPawnDy[] = {-1, -1};
+
+inline constexpr std::array<Bitboard, 64> knight = buildTable(knightDx, knightDy);
+inline constexpr std::array<Bitboard, 64> king = buildTable(kingDx, kingDy);
+/// squares attacked by a pawn, indexed by FigurePlayer first
+inline constexpr std::array<std::array<Bitboard, 64>, 2> pawn
+    = {buildTable(whitePawnDx, whitePawnDy), buildTable(blackPawnDx, blackPawnDy)};
+
+static_assert(knight[square(0, 0)] == (bit(1, 2) | bit(2, 1)), "knight table is broken");
+static_assert(king[square(7, 7)] == (bit(6, 7) | bit(6, 6) | bit(7, 6)), "king table is broken");
+static_assert(pawn[0][square(0, 1)] == bit(1, 2), "pawn table is broken");
+
+/// squares from (x, y) towards (dx, dy) up to and including the first taken one
+inline Bitboard ray(int x, int y, int dx, int dy, Bitboard taken)
+{
+    Bitboard squares = 0;
+    for (x += dx, y += dy; x >= 0 && x < 8 && y >= 0 && y < 8; x += dx, y += dy) {
+        auto b = bit(x, y);
+        squares |= b;
+        if (taken & b)
+            break;
+    }
+    return squares;
+}
+
+inline Bitboard rook(int square, Bitboard taken)
+{
+    const int x = square % 8, y = square / 8;
+    return ray(x, y, 1, 0, taken) | ray(x, y, -1, 0, taken) | ray(x, y, 0, 1, taken)
+        | ray(x, y, 0, -1, taken);
+}
+
+inline Bitboard bishop(int square, Bitboard taken)
+{
+    const int x = square % 8, y = square / 8;
+    return ray(x, y, 1, 1, taken) | ray(x, y, -1, 1, taken) | ray(x, y, 1, -1, taken)
+        | ray(x, y, -1, -1, taken);
+}
+
+/// index of the lowest set square, set must not be empty
+inline int lowest(Bitboard squares)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, squares);
+    return (int)index;
+#else
+    return __builtin_ctzll(squares);
+#endif
+}
+
+/// removes lowest set square and returns its index
+inline int popLowest(Bitboard& squares)
+{
+    int index = lowest(squares);
+    squares &= squares - 1;
+    return index;
+}
+
+} // namespace Attacks
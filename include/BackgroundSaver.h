@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Chessboard.h"
+#include "Saver.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Writes savefiles on a thread of its own, so the game never waits for the
+/// disk. Boards are copied when a save is requested; a save that is still
+/// waiting when the next one comes is replaced by it
+class BackgroundSaver {
+    PSaver saver;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    /// latest requested copy nobody started writing yet
+    PChessboard pending;
+    bool writing = false;
+    bool stopping = false;
+    std::vector<std::string> reports;
+    std::thread writer;
+    void work();
+
+public:
+    explicit BackgroundSaver(PSaver saver);
+    /// writes the pending save before returning
+    ~BackgroundSaver();
+    BackgroundSaver(const BackgroundSaver&) = delete;
+    BackgroundSaver& operator=(const BackgroundSaver&) = delete;
+
+    /// copies board and returns at once
+    void save(const Chessboard& board);
+    /// blocks until every requested save is written
+    void flush();
+    /// messages about finished saves since the previous call, oldest first
+    std::vector<std::string> takeReports();
+};
+
+typedef std::shared_ptr<BackgroundSaver> PBackgroundSaver;
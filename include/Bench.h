@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Chessboard.h"
+#include "ViewSide.h"
+
+#include <cstdint>
+#include <string>
+
+/// Walks the move tree of a built-in position set to a fixed depth and reports
+/// node count and speed, used to track move generation throughput between builds
+class Bench {
+    unsigned int depth;
+
+public:
+    explicit Bench(unsigned int depth = 2);
+    /// returns total amount of visited leaf nodes, which doubles as a signature
+    std::uint64_t run(const PViewSide& view) const;
+    /// counts leaf nodes of the legal move tree of given depth
+    static std::uint64_t perft(const PChessboard& board, unsigned int depth);
+    /// builds board from FEN, see Fen::parse
+    static PChessboard loadPosition(const std::string& fen);
+};
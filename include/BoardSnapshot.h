@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Figure.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/// Compact immutable copy of a position: 4 bits per square plus the state that
+/// figures keep on their own. Trivially copyable, so it can be handed over to
+/// other threads by value
+class BoardSnapshot {
+public:
+    enum Castling : std::uint8_t {
+        WhitesKingSide = 1,
+        WhitesQueenSide = 2,
+        BlacksKingSide = 4,
+        BlacksQueenSide = 8
+    };
+    /// code of a square without figure
+    static constexpr std::uint8_t Empty = 0;
+    static constexpr std::uint8_t NoEnPassant = 0xFF;
+    /// bytes taken by pack: squares, dead counts, castling, en passant, side to move,
+    /// halfmove clock and ply, numbers are little endian
+    static constexpr std::size_t PackedSize = 32 + 10 + 3 + 2 + 4;
+
+private:
+    /// two squares per byte, lower nibble is the even square
+    std::array<std::uint8_t, 32> squares{};
+    /// captured figures by FigurePlayer and FigureType, kings are never captured
+    std::array<std::array<std::uint8_t, 5>, 2> dead{};
+    std::uint8_t castling = 0;
+    std::uint8_t enPassant = NoEnPassant;
+    bool whitesTurn = true;
+    std::uint16_t halfmoveClock = 0;
+    std::uint32_t ply = 0;
+
+public:
+    /// 1 + type for Whites, 9 + type for Blacks
+    static constexpr std::uint8_t code(FigureType type, FigurePlayer player)
+    {
+        return (std::uint8_t)(1 + type + 8 * player);
+    }
+
+    std::uint8_t get(int square) const;
+    void set(int square, std::uint8_t code);
+    bool isEmpty(int square) const;
+    /// only meaningful for taken squares
+    FigureType getType(int square) const;
+    FigurePlayer getPlayer(int square) const;
+    unsigned int getDeadCount(FigurePlayer player, FigureType type) const;
+    void setDeadCount(FigurePlayer player, FigureType type, unsigned int count);
+    std::uint8_t getCastling() const;
+    bool canCastle(Castling right) const;
+    void setCastling(std::uint8_t rights);
+    /// square skipped by the last double pawn step, NoEnPassant if none
+    std::uint8_t getEnPassant() const;
+    void setEnPassant(std::uint8_t square);
+    bool getWhitesTurn() const;
+    void setWhitesTurn(bool whitesTurn);
+    std::uint16_t getHalfmoveClock() const;
+    void setHalfmoveClock(std::uint16_t halfmoveClock);
+    std::uint32_t getPly() const;
+    void setPly(std::uint32_t ply);
+    /// writes PackedSize bytes, the layout does not depend on the platform
+    void pack(std::uint8_t* out) const;
+    /// reads PackedSize bytes written by pack, throws on codes that are not figures
+    static BoardSnapshot unpack(const std::uint8_t* data);
+    bool operator==(const BoardSnapshot& snapshot) const;
+    bool operator!=(const BoardSnapshot& snapshot) const;
+};
+
+static_assert(sizeof(BoardSnapshot) < 128, "snapshot must stay compact");
+static_assert(std::is_trivially_copyable<BoardSnapshot>::value, "snapshot is copied by memcpy");
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Chessboard.h"
+#include "PolyglotBook.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// Totals of one book build
+struct BookBuildStats {
+    std::uint64_t games = 0;
+    /// games with moves that could not be played and broken journals
+    std::uint64_t skipped = 0;
+    std::uint64_t positions = 0;
+    /// moves written to the book
+    std::uint64_t entries = 0;
+    /// moves left out for being played too rarely or scoring too low
+    std::uint64_t pruned = 0;
+    double seconds = 0;
+    /// peak memory of the whole process in bytes, 0 if the platform does not tell
+    std::uint64_t peakMemory = 0;
+    std::string asString() const;
+};
+
+/// Collects moves of finished games into a Polyglot book. Positions are spread
+/// over shards by key, each with its own lock, so games can be added from many
+/// threads at once
+class BookBuilder {
+public:
+    static constexpr unsigned int DefaultMaxPly = 40;
+
+private:
+    static constexpr unsigned int ShardCount = 64;
+    struct MoveStats {
+        /// as PolyglotKeys::encode writes it
+        std::uint16_t move;
+        std::uint32_t games;
+        /// half points the mover got: 2 for a win, 1 for a draw or unknown result
+        std::uint32_t score;
+    };
+    struct Shard {
+        std::mutex lock;
+        std::unordered_map<std::uint64_t, std::vector<MoveStats>> positions;
+    };
+
+    PolyglotKeys keys;
+    unsigned int threads;
+    unsigned int minGames;
+    unsigned int minScore;
+    unsigned int maxPly;
+    std::array<Shard, ShardCount> shards;
+    std::atomic<std::uint64_t> games{0};
+    std::atomic<std::uint64_t> skipped{0};
+    BookBuildStats stats;
+
+public:
+    /// moves played in fewer than minGames games or scoring below minScore percent
+    /// for the mover are left out, only the first maxPly plies of a game are taken
+    explicit BookBuilder(PolyglotKeys keys = PolyglotKeys(), unsigned int threads = 1,
+                         unsigned int minGames = 1, unsigned int minScore = 0,
+                         unsigned int maxPly = DefaultMaxPly);
+    /// replays board's moves from its start position, results other than "1-0",
+    /// "0-1" and "1/2-1/2" count as draws, safe to call from several threads
+    void addGame(const Chessboard& board, std::string_view result);
+    /// reads PGN and journal files, told apart by their contents. PGN text is split
+    /// between the threads, journals are handed out to them one by one.
+    /// Throws runtime_error if a file cannot be opened
+    void addFiles(const std::vector<std::string>& fileNames);
+    /// writes the book sorted by key, heaviest moves first, weights are 2 per win
+    /// and 1 per draw of the mover scaled down to fit 16 bits.
+    /// Throws runtime_error if file cannot be written
+    void write(const std::string& fileName);
+    BookBuildStats getStats() const;
+};
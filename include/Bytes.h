@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Numbers stored in files with a fixed byte order, whatever the platform is
+namespace Bytes {
+
+template <typename T>
+inline void storeLittle(std::uint8_t* out, T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        out[i] = (std::uint8_t)(value >> (8 * i));
+}
+
+template <typename T>
+inline T loadLittle(const std::uint8_t* data)
+{
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        value |= (T)data[i] << (8 * i);
+    return value;
+}
+
+template <typename T>
+inline void storeBig(std::uint8_t* out, T value)
+{
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        out[i] = (std::uint8_t)(value >> (8 * (sizeof(T) - 1 - i)));
+}
+
+template <typename T>
+inline T loadBig(const std::uint8_t* data)
+{
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i)
+        value = (T)(value << 8 | data[i]);
+    return value;
+}
+
+} // namespace Bytes
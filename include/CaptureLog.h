@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/// One capture of the game, figures are referred to by their board ids
+struct Capture {
+    unsigned int ply;
+    std::uint8_t capturedId;
+    std::uint8_t capturingId;
+    /// y * 8 + x
+    std::uint8_t square;
+};
+
+/// Append-only list of captures made during one game
+class CaptureLog {
+    std::vector<Capture> entries;
+
+public:
+    /// capturer of figures that were loaded or placed already dead
+    static constexpr std::uint8_t Nobody = 0xFF;
+
+    void record(unsigned int ply, unsigned int capturedId, unsigned int capturingId, int square);
+    void clear();
+    const std::vector<Capture>& getEntries() const;
+    std::size_t size() const;
+    /// the last entry about given figure, nullptr if it was never captured
+    const Capture* findCaptured(unsigned int id) const;
+};
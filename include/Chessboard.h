@@ -1,21 +1,74 @@
 
 #pragma once
 
+#include "BoardSnapshot.h"
+#include "CaptureLog.h"
 #include "Figure.h"
+#include "Move.h"
+#include "MoveCache.h"
+#include "MoveGenerator.h"
 #include "PathSystem.h"
 #include "Point.h"
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 class Chessboard {
+public:
+    /// figure ids are below that number
+    static constexpr unsigned int MaxFigures = 64;
+
 protected:
     PFigures m_board;
-    PFigures m_deadFigures;
+    /// dead figures are the ones found here and not revived since
+    CaptureLog m_captures;
+    /// half-moves made since the game started
+    unsigned int m_ply = 0;
     PPathSystem m_pathSystem;
     bool whitesTurn = true;
+    /// legal moves of each side, published once per position so that many
+    /// threads may read one board while nobody moves on it
+    mutable std::array<std::atomic<const MoveCache*>, 2> m_moveCaches{};
+    /// alive figure standing at each square
+    std::array<PFigure, 64> m_squares;
+    /// every figure of the game by its id, alive or dead
+    std::array<PFigure, MaxFigures> m_figures;
+    /// square of every figure by its id, -1 for dead ones
+    std::array<int, MaxFigures> m_figureSquares;
+    /// zobrist hash of figures and castling rights, side to move is added on request
+    std::uint64_t m_placementHash = 0;
+    /// placement hashes since the last irreversible move, the current one is last
+    std::vector<std::uint64_t> m_history;
+    /// moves played since the game was set up, in order
+    std::vector<Move> m_moves;
+    /// position the moves start from, taken when the first one is played
+    BoardSnapshot m_start;
+    /// plies since the last capture or pawn move
+    unsigned int m_halfmoveClock = 0;
+    /// square skipped by a pawn's double step on the previous ply, -1 if none
+    int m_enPassant = -1;
+    /// alive figures by FigurePlayer and FigureType, updated by every move
+    std::array<std::array<unsigned int, 6>, 2> m_figureCounts{};
     void destroy();
+    /// builds and publishes legal moves of given side unless somebody already did
+    const MoveCache& movesOf(FigurePlayer side) const;
+    void dropMoveCaches();
+    /// BoardSnapshot castling rights given by unmoved kings and rooks
+    std::uint8_t castlingRights() const;
+    /// recounts figures and forgets previous positions,
+    /// used when the game is set up from scratch
+    void restartRecords();
+    /// gives figure an id unless it already owns one on this board
+    void registerFigure(const PFigure& fig);
+    /// invalidates cached moves, rebuilds square indexes and resyncs path system
+    void positionChanged();
     void performMovement(
         const PFigure& figure, const PPoint& toPlace);
 
@@ -23,21 +76,88 @@ public:
     Chessboard();
     ~Chessboard();
     PFigure at(const PPoint& point) const;
-    /// returns true if move was successfully made
-    bool prepareMove(const PPoint& from, const PPoint& to);
+    /// square is y * 8 + x
+    PFigure atSquare(int square) const;
+    PFigure getFigure(unsigned int id) const;
+    /// -1 if figure is dead or unknown
+    int getSquare(unsigned int id) const;
+    /// returns true if move was successfully made, promotion is only used by
+    /// pawns reaching the last rank; a dead figure of that type is revived if any
+    bool prepareMove(const PPoint& from, const PPoint& to, FigureType promotion = Queen);
+    /// true if the move brings a pawn to the last rank
+    bool isPromotion(const Move& move) const;
+    /// checks one move without generating the rest of the side's moves
+    bool isLegal(const Move& move) const;
     /// create fresh figures and place them on board
     void initialize();
     void setTurn(bool whitesTurn);
     bool getWhitesTurn() const;
     bool onePlayerLeft() const;
-    std::multimap<PFigure, PPoint> canMoveFrom(
-        FigurePlayer side) const;
+    unsigned int getFigureCount(FigurePlayer side, FigureType type) const;
+    unsigned int getHalfmoveClock() const;
+    bool isInCheck(FigurePlayer side) const;
+    /// true if any figure of side attacks square, looked up backwards from the square
+    bool isAttacked(int square, FigurePlayer side) const;
+    /// squares of figures of both sides attacking square
+    Bitboard attackersTo(int square) const;
+    /// a hundred plies without captures and pawn moves
+    bool isFiftyMoveRule() const;
+    /// nobody can checkmate: bare kings or a single knight or bishop left
+    bool hasInsufficientMaterial() const;
+    std::uint64_t getHash() const;
+    /// how many times current position occurred before with the same side to move
+    unsigned int repetitions() const;
+    /// enough for a search to call it a draw
+    bool isRepetition() const;
+    bool isThreefoldRepetition() const;
+    /// legal moves of given side, computed once per position
+    const std::multimap<PFigure, PPoint>& canMoveFrom(FigurePlayer side) const;
+    /// legal destinations of figure standing at given point
+    PPoints getPath(const PPoint& from) const;
+    /// every legal move once: a promotion per figure type, castling only as a king's move
+    std::vector<Move> listMoves(FigurePlayer side) const;
+    /// same moves as listMoves, produced one by one, captures first
+    MoveGenerator generateMoves(FigurePlayer side) const;
+    /// stops at the first legal move found
+    bool hasAnyLegalMove(FigurePlayer side) const;
+    /// squares taken by alive figures of given side
+    Bitboard occupancy(FigurePlayer side) const;
+    /// squares figure can go to, king safety is not checked
+    Bitboard buildTargets(const PFigure& figure) const;
+    /// true if move of figure to square leaves its king safe
+    bool keepsKingSafe(const PFigure& figure, int to) const;
+    int getEnPassant() const;
+    /// square behind a pawn that just made a double step, -1 to clear
+    void setEnPassant(int square);
+    unsigned int getPly() const;
+    /// moves played since the board was set up, promotion is Queen for non-promoting ones
+    const std::vector<Move>& getMoves() const;
+    /// position before the first of getMoves, the current one if there are no moves
+    BoardSnapshot getStartPosition() const;
+    /// replaces the record of played moves, the position itself is not touched
+    void setMoves(const BoardSnapshot& start, std::vector<Move> moves);
+    const CaptureLog& getCaptures() const;
+    /// figures captured during the game and not revived, in order of capture
+    PFigures getDeadFigures() const;
     // save-load needed functions
-    explicit Chessboard(const PFigures& figures);
+    /// dead figures missing from the log are recorded as captured by nobody
+    explicit Chessboard(
+        const PFigures& figures, const CaptureLog& captures = CaptureLog(), unsigned int ply = 0);
     PFigures getAllFigures() const;
     PFigures getBoard() const;
     void addFigure(PFigure fig);
+    /// records figure as captured by nobody
     void addDeadFigure(PFigure fig);
+    /// independent copy, every figure is rebuilt
+    std::shared_ptr<Chessboard> clone() const;
+    /// compact copy of the position, figure ids and capture history are not kept
+    BoardSnapshot snapshot() const;
+    /// replaces the whole game with fresh figures standing as in snapshot
+    void restore(const BoardSnapshot& snapshot);
+    explicit Chessboard(const BoardSnapshot& snapshot);
+    /// replaces the whole game with the position written in FEN
+    void loadFen(std::string_view fen);
+    std::string toFen() const;
 };
 
 typedef std::shared_ptr<Chessboard> PChessboard;
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "BoardSnapshot.h"
+
+#include <string>
+#include <string_view>
+
+/// Forsyth-Edwards Notation of a position. Parsing is a single pass over the
+/// text straight into a snapshot, nothing is allocated unless the text is broken
+class Fen {
+public:
+    static constexpr std::string_view StartPosition
+        = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    /// placement and side to move are required, missing fields default to "- - 0 1"
+    static BoardSnapshot parse(std::string_view fen);
+    static std::string write(const BoardSnapshot& snapshot);
+};
@@ -16,22 +16,27 @@ typedef std::list<PFigure> PFigures;
 /// Figure class
 class Figure {
     PPoint position;
-    PFigure killedBy;
+    /// who captured it is kept by the board's CaptureLog
+    bool captured;
     FigurePlayer player;
     FigureType type;
     unsigned int movesMade;
+    unsigned int id;
 
 public:
+    /// id of a figure which was never placed on a board
+    static constexpr unsigned int NoId = ~0u;
+
     Figure(
         Point point,
         FigureType type,
         FigurePlayer player,
         unsigned int movesMade = 0,
-        PFigure killedBy = nullptr);
+        bool captured = false);
     Figure(const Figure& figure);
     Figure& operator=(const Figure& b);
     ~Figure();
-    void isCapturedBy(const PFigure& by);
+    void capture();
     void revive();
     char asChar() const;
     bool isAlive() const;
@@ -47,9 +52,11 @@ public:
     PPoint getPoint() const;
     int getX() const; // point alias
     int getY() const; // point alias
-    PFigure getKilledBy() const;
     void moved();
     unsigned int getMovesCount() const;
+    /// small number stable for the whole game, given by the board
+    unsigned int getId() const;
+    void setId(unsigned int id);
     bool operator==(const Figure& figure) const;
     bool operator!=(const Figure& figure) const;
 };
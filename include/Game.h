@@ -1,25 +1,65 @@
 #pragma once
 
+#include "BackgroundSaver.h"
 #include "Chessboard.h"
 #include "Figure.h"
+#include "GameClock.h"
+#include "Journal.h"
 #include "Point.h"
+#include "PolyglotBook.h"
+#include "PositionDb.h"
 #include "Saver.h"
+#include "Search.h"
+#include "Tablebase.h"
+#include "TimeManager.h"
 #include "ViewSide.h"
 
 #include <memory>
 #include <set>
+#include <string>
+
+enum GameResult : int { WhitesWon = 0, BlacksWon, Draw };
 
 class Game {
     PViewSide view;
     PSaver saver;
+    /// writes what saver would, but off the game thread
+    PBackgroundSaver backgroundSaver;
+    PJournal journal;
+    /// finished games are appended here as PGN, nothing is written if empty
+    std::string pgnFile;
+    /// statistics of positions seen in earlier games, shown before each move if given
+    PPositionDb positionDb;
+    /// engine moves come from here while the position is in book
+    PPolyglotBook book;
+    unsigned int bookHits = 0;
+    /// endgames found here are played perfectly without thinking
+    PTablebase tablebase;
     PChessboard checkboard;
+    PGameClock gameClock;
+    PTimeManager timeManager;
+    PSearch search;
 
     PFigure selectFigure(const std::set<PFigure>& set);
+    /// stops mover's clock, returns false if mover ran out of time
+    bool punchClock(FigurePlayer side);
+    /// records the last move to the journal, or restarts it from the current position
+    void autosave(bool restart);
+    /// shows how the saves finished since the last time
+    void renderSaveReports();
+    GameResult play();
+    void recordGame(GameResult result);
 
 public:
-    Game(PViewSide viewSide, PSaver saver);
+    /// plays without time limits if no clock is given, every move
+    /// is journaled if journal is given
+    Game(PViewSide viewSide, PSaver saver, PGameClock gameClock = nullptr,
+         PJournal journal = nullptr, std::string pgnFile = "", PPositionDb positionDb = nullptr,
+         PPolyglotBook book = nullptr, PTablebase tablebase = nullptr);
 
     ~Game();
 
-    bool run();
+    GameResult run();
+    /// engine moves taken from book instead of searched
+    unsigned int getBookHits() const;
 };
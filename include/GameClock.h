@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Figure.h"
+
+#include <chrono>
+#include <memory>
+
+/// Chess clock for both sides: base time plus increment, optionally refilled
+/// with the base time every movesToGo moves (classical time control)
+class GameClock {
+    typedef std::chrono::steady_clock clock;
+
+    std::chrono::milliseconds base;
+    std::chrono::milliseconds increment;
+    unsigned int movesPerPeriod; /// 0 means sudden death
+    std::chrono::milliseconds remaining[2];
+    unsigned int movesMade[2];
+    clock::time_point turnStarted;
+    FigurePlayer running;
+    bool ticking;
+
+public:
+    GameClock(
+        std::chrono::milliseconds base,
+        std::chrono::milliseconds increment = std::chrono::milliseconds(0),
+        unsigned int movesToGo = 0);
+    /// back to initial time for both sides
+    void reset();
+    /// starts counting time of given side, keeps counting if it is already running
+    void start(FigurePlayer side);
+    /// stops running side's time after it completed a move
+    void stop();
+    std::chrono::milliseconds getRemaining(FigurePlayer side) const;
+    std::chrono::milliseconds getIncrement() const;
+    /// moves left until next time refill, 0 for sudden death
+    unsigned int getMovesToGo(FigurePlayer side) const;
+    bool isFlagged(FigurePlayer side) const;
+};
+
+typedef std::shared_ptr<GameClock> PGameClock;
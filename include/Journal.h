@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Chessboard.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+/// Append-only record of a game: a checkpoint with the whole position,
+/// then one small record per move. Every record is flushed as soon as it is
+/// written, so a crashed game loses at most the move being written
+class Journal {
+    std::string fileName;
+    unsigned int checkpointInterval;
+    unsigned int movesSinceCheckpoint = 0;
+    std::ofstream file;
+    void write(const std::uint8_t* data, std::size_t size);
+
+public:
+    static constexpr unsigned int DefaultCheckpointInterval = 32;
+
+    explicit Journal(
+        std::string fileName, unsigned int checkpointInterval = DefaultCheckpointInterval);
+    /// truncates the file and starts it with board's current position
+    void start(const Chessboard& board);
+    /// records the last move played on board, adds a checkpoint every checkpointInterval moves
+    void append(const Chessboard& board);
+    /// records the whole position, later loads replay from here
+    void checkpoint(const Chessboard& board);
+    bool isStarted() const;
+    /// replays the moves found after the last checkpoint, a torn last record is ignored
+    PChessboard load() const;
+    /// true if data starts like a journal file
+    static bool isJournal(const std::uint8_t* data, std::size_t size);
+    /// with wholeGame replays from the first checkpoint, so the board's moves
+    /// cover everything journaled since the last start
+    static PChessboard replay(const std::uint8_t* data, std::size_t size, bool wholeGame = false);
+};
+
+typedef std::shared_ptr<Journal> PJournal;
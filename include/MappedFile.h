@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Read-only view of a whole file mapped into memory, unmapped on destruction
+class MappedFile {
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+#if defined(_WIN32)
+    void* file = nullptr;
+    void* mapping = nullptr;
+#else
+    int file = -1;
+#endif
+    void close();
+
+public:
+    /// throws runtime_error if file cannot be opened or mapped
+    explicit MappedFile(const std::string& fileName);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// nullptr for an empty file
+    const std::uint8_t* getData() const;
+    std::size_t getSize() const;
+};
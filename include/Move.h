@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Figure.h"
+#include "Point.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Compact move between two board squares, squares are stored as y * 8 + x.
+/// Promotion figure only matters for pawns reaching the last rank
+class Move {
+    std::uint8_t from;
+    std::uint8_t to;
+    std::uint8_t promotion;
+
+public:
+    /// bytes taken by pack: from, to and promotion
+    static constexpr std::size_t PackedSize = 3;
+
+    explicit Move(
+        const Point& from = Point(), const Point& to = Point(), FigureType promotion = Queen);
+    Point getFrom() const;
+    Point getTo() const;
+    FigureType getPromotion() const;
+    std::string asString() const;
+    void pack(std::uint8_t* out) const;
+    /// throws on squares out of board and promotions to pawn or king
+    static Move unpack(const std::uint8_t* data);
+    bool operator==(const Move& move) const;
+    bool operator!=(const Move& move) const;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Attacks.h"
+#include "Figure.h"
+#include "Move.h"
+#include "Point.h"
+
+#include <array>
+#include <map>
+
+/// Legal moves of one side in one position, indexed by from-square
+class MoveCache {
+    std::multimap<PFigure, PPoint> moves;
+    std::array<Bitboard, 64> targets;
+
+public:
+    MoveCache();
+    void fill(std::multimap<PFigure, PPoint> moves);
+    const std::multimap<PFigure, PPoint>& getMoves() const;
+    /// legal destinations of figure standing at given point
+    Bitboard getTargets(const Point& from) const;
+    bool contains(const Move& move) const;
+};
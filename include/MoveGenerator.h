@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Attacks.h"
+#include "Figure.h"
+#include "Move.h"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+
+class Chessboard;
+
+/// Lazily produces legal moves of one side: captures of every figure first,
+/// then quiet moves. Figure's squares are built when the figure is reached,
+/// so callers that stop early do not pay for the rest. Board must outlive it
+/// and stay unchanged while moves are taken
+class MoveGenerator {
+public:
+    enum Stage : int { Captures = 0, Quiets, Done };
+
+private:
+    const Chessboard& board;
+    FigurePlayer side;
+    Stage stage;
+    /// figure id being walked in current stage
+    unsigned int id;
+    /// squares left for current figure in current stage
+    Bitboard pending;
+    /// pseudo legal squares by figure id, filled on the first visit
+    std::array<Bitboard, 64> targets;
+    std::array<bool, 64> built;
+    Bitboard enemies;
+    Bitboard taken;
+    /// promotions still to hand out for the last promoting move
+    unsigned int promotionsLeft;
+    Move promotionMove;
+
+    /// moves to next figure or stage, false when all stages are done
+    bool advance();
+
+public:
+    class iterator {
+        MoveGenerator* generator;
+        Move current;
+
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef Move value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Move* pointer;
+        typedef const Move& reference;
+
+        explicit iterator(MoveGenerator* generator = nullptr);
+        reference operator*() const;
+        pointer operator->() const;
+        iterator& operator++();
+        bool operator==(const iterator& other) const;
+        bool operator!=(const iterator& other) const;
+    };
+
+    MoveGenerator(const Chessboard& board, FigurePlayer side);
+    /// writes the next legal move, returns false when there are no more
+    bool next(Move& move);
+    Stage getStage() const;
+    iterator begin();
+    iterator end();
+};
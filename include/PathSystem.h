@@ -1,21 +1,60 @@
 #pragma once
 
+#include "Attacks.h"
 #include "Figure.h"
 #include "Point.h"
 
+#include <array>
 #include <list>
 #include <map>
 #include <memory>
 
+/// Side dependent constants of move generation
+template <FigurePlayer side>
+struct SideTraits {
+    static constexpr FigurePlayer enemy = side == Whites ? Blacks : Whites;
+    static constexpr int pawnStep = side == Whites ? 1 : -1;
+    static constexpr unsigned int homeRank = side == Whites ? 0 : 7;
+    static constexpr unsigned int promotionRank = side == Whites ? 7 : 0;
+    static constexpr unsigned int kingFile = 4;
+    static constexpr unsigned int queenRookFile = 0;
+    static constexpr unsigned int kingRookFile = 7;
+};
+
 class PathSystem {
+    /// figures of one side grouped by FigureType
+    typedef std::array<PFigures, 6> FiguresByType;
+    /// squares of alive figures indexed by FigurePlayer and FigureType
+    typedef std::array<std::array<Bitboard, 6>, 2> Placement;
+
     PFigures board;
+    /// figure standing at each square
+    std::array<PFigure, 64> squares;
+    /// square skipped by the last double pawn step, -1 if none
+    int enPassant = -1;
+    void indexSquares();
     PFigure at(const PPoint& point) const;
-    PPoint addOrDie(const PPoint& point, FigurePlayer side, bool pawnMode) const;
-    PPoints buildPawnPath(const PFigure& figure) const;
-    PPoints buildKnightPath(const PFigure& figure) const;
-    PPoints buildRookPath(const PFigure& figure) const;
-    PPoints buildBishopPath(const PFigure& figure) const;
-    PPoints buildKingPath(const PFigure& figure) const;
+    /// squares taken by alive figures of given side
+    Bitboard occupancy(FigurePlayer side) const;
+    Placement placement() const;
+    static PPoints toPoints(Bitboard squares);
+    static bool isAttacked(int square, FigurePlayer by, const Placement& placement);
+    static Bitboard attackersTo(int square, const Placement& placement);
+    /// plays the move on a copy of placement, figures stay untouched
+    bool kingAttackedAfter(const PFigure& figure, int to) const;
+    template <FigurePlayer side>
+    Bitboard buildPawnPath(const PFigure& figure, Bitboard own, Bitboard enemy) const;
+    template <FigurePlayer side>
+    Bitboard buildRookPath(const PFigure& figure, Bitboard own, Bitboard enemy) const;
+    template <FigurePlayer side>
+    Bitboard buildKingPath(const PFigure& figure, Bitboard own) const;
+    template <FigurePlayer side, FigureType type>
+    Bitboard buildPathFor(const PFigure& figure, Bitboard own, Bitboard enemy) const;
+    template <FigurePlayer side>
+    void collectPaths(const FiguresByType& figures, Bitboard own, Bitboard enemy,
+                      std::multimap<PFigure, PPoint>& moves) const;
+    template <FigurePlayer side>
+    std::multimap<PFigure, PPoint> getRawListOfMovesFor() const;
     std::multimap<PFigure, PPoint> getRawListOfMoves(FigurePlayer side) const;
     PFigure getKing(FigurePlayer side) const;
 
@@ -23,13 +62,27 @@ public:
     PathSystem();
     explicit PathSystem(const PFigures& board);
     PPoints buildPath(const PFigure& figure) const;
+    /// squares figure can go to, king safety is not checked
+    Bitboard buildSquares(const PFigure& figure) const;
+    /// true if moving figure to square neither captures enemy king nor exposes its own
+    bool keepsKingSafe(const PFigure& figure, int to) const;
     const PFigures& getBoard() const;
     void setBoard(const PFigures& list);
+    void setEnPassant(int square);
     // returns true if move can be made
     bool checkForMovement(const PFigure& from, const PPoint& to) const;
+    /// figure's own path plus king safety, the rest of the side is not generated
+    bool isLegal(const PFigure& figure, const PPoint& to) const;
     PPoints checkForAnyMovement(const PFigure& from) const;
+    /// never touches figures, so it can run from several threads at once
     std::multimap<PFigure, PPoint> getListOfAvailableMoves(FigurePlayer side) const;
     bool checkCastling(const PFigure& one, const PFigure& two) const;
+    /// false if side has no king
+    bool isInCheck(FigurePlayer side) const;
+    /// true if any alive figure of side by attacks square
+    bool isAttacked(int square, FigurePlayer by) const;
+    /// squares of alive figures of both sides attacking square
+    Bitboard attackersTo(int square) const;
 };
 
 typedef std::shared_ptr<PathSystem> PPathSystem;
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Chessboard.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// One game read from PGN. Tags and result point into the text being read
+/// and stay valid only while the callback runs
+struct PgnGame {
+    std::vector<std::pair<std::string_view, std::string_view>> tags;
+    /// "1-0", "0-1", "1/2-1/2" or "*", empty if the game was cut short
+    std::string_view result;
+    /// position after the last move, the moves themselves are in getMoves()
+    PChessboard board;
+    /// value as written in the file, empty if there is no such tag
+    std::string_view tag(std::string_view name) const;
+};
+
+/// Totals of one read
+struct PgnStats {
+    std::uint64_t games = 0;
+    /// games with moves that could not be played, they never reach the callback
+    std::uint64_t skipped = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t bytes = 0;
+    double seconds = 0;
+    double gamesPerSecond() const;
+    double megabytesPerSecond() const;
+    std::string asString() const;
+};
+
+/// Reads PGN games one after another and replays their moves on a Chessboard.
+/// Tokens are views into the text, nothing is copied out of it
+class PgnReader {
+public:
+    typedef std::function<void(const PgnGame&)> Callback;
+
+private:
+    unsigned int threads;
+    static PgnStats readPart(std::string_view text, const Callback& callback);
+    /// offset of the first tag section starting at or after from, size of text if none
+    static std::size_t nextGameStart(std::string_view text, std::size_t from);
+
+public:
+    /// with more than one thread text is split at game boundaries and
+    /// callback is called from all of them at once
+    explicit PgnReader(unsigned int threads = 1);
+    PgnStats read(std::string_view text, const Callback& callback) const;
+    /// maps the whole file and reads it, throws runtime_error if it cannot be opened
+    PgnStats readFile(const std::string& fileName, const Callback& callback) const;
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Chessboard.h"
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// Writes games as PGN into a buffer that is kept between games, so the text
+/// only allocates while the buffer is still growing. Moves are still replayed
+/// on a board to write their SAN, which allocates as any move played does
+class PgnWriter {
+public:
+    typedef std::vector<std::pair<std::string_view, std::string_view>> Tags;
+
+private:
+    std::string buffer;
+    /// buffer offset of the current movetext line
+    std::size_t lineStart = 0;
+    /// appends text to the movetext, wrapping lines at 80 characters
+    void appendToken(std::string_view token);
+    void appendTag(std::string_view name, std::string_view value);
+
+public:
+    /// "1-0", "0-1" or "1/2-1/2" when the position settles it, "*" otherwise
+    static std::string_view resultOf(const Chessboard& board);
+
+    /// appends board's moves from its start position, the seven tag roster
+    /// is completed with "?" and result is taken from the position if empty
+    void write(const Chessboard& board, const Tags& tags = {}, std::string_view result = {});
+    const std::string& getBuffer() const;
+    /// forgets written games, the memory is kept
+    void clear();
+    /// writes the buffer out and clears it
+    void flush(std::ostream& stream);
+};
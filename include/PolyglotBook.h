@@ -0,0 +1,77 @@
+#pragma once
+
+#include "BoardSnapshot.h"
+#include "Chessboard.h"
+#include "MappedFile.h"
+#include "Move.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Random numbers Polyglot keys are made of, laid out as Polyglot does:
+/// 768 for figures (64 * kind + 8 * row + file, kinds go black pawn, white pawn,
+/// black knight, white knight and so on up to white king), 4 for castling rights
+/// (white short, white long, black short, black long), 8 for en passant files
+/// and 1 for Whites to move
+class PolyglotKeys {
+public:
+    static constexpr std::size_t Size = 781;
+
+private:
+    std::array<std::uint64_t, Size> random;
+
+public:
+    /// the Random64 table of Polyglot, so keys match books of any other program
+    PolyglotKeys();
+    /// reads Size hexadecimal numbers written with 0x in front, for books built with
+    /// other numbers, throws runtime_error if there are not exactly Size
+    static PolyglotKeys load(const std::string& fileName);
+    /// en passant counts only if a pawn of the side to move can take it, as in Polyglot
+    std::uint64_t hash(const BoardSnapshot& snapshot) const;
+    std::uint64_t hash(const Chessboard& board) const;
+
+    /// move as Polyglot stores it: to file, to row, from file, from row and promotion
+    /// by 3 bits each, castling is written as the king taking its own rook
+    static std::uint16_t encode(const BoardSnapshot& snapshot, const Move& move);
+    /// reverse of encode, the move is not checked for legality
+    static Move decode(const BoardSnapshot& snapshot, std::uint16_t move);
+};
+
+struct BookEntry {
+    Move move;
+    std::uint16_t weight = 0;
+    std::uint32_t learn = 0;
+};
+
+/// Read-only Polyglot .bin book mapped from a file. Entries are 16 bytes, big endian:
+/// key, move, weight and learn, sorted by key, so a lookup is a binary search
+class PolyglotBook {
+public:
+    static constexpr std::size_t EntrySize = 16;
+    enum Selection { Best, Weighted };
+
+private:
+    MappedFile file;
+    PolyglotKeys keys;
+    Selection selection;
+    std::size_t entryCount;
+    std::mt19937_64 random;
+
+public:
+    /// throws runtime_error if file is missing or its size is not a multiple of EntrySize
+    explicit PolyglotBook(const std::string& fileName, PolyglotKeys keys = PolyglotKeys(),
+                          Selection selection = Weighted);
+    /// legal moves stored for board, heaviest first
+    std::vector<BookEntry> find(const Chessboard& board) const;
+    /// picks the heaviest move or a random one with odds given by weights,
+    /// moves weighing nothing are never picked, false if board is out of book
+    bool pick(const Chessboard& board, Move& move);
+    std::size_t size() const;
+};
+
+typedef std::shared_ptr<PolyglotBook> PPolyglotBook;
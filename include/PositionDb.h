@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Chessboard.h"
+#include "MappedFile.h"
+#include "Move.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// How games went on from one position
+struct PositionStats {
+    std::uint32_t whitesWon = 0;
+    std::uint32_t draws = 0;
+    std::uint32_t blacksWon = 0;
+    /// moves played from the position and how often, most frequent first
+    std::vector<std::pair<Move, std::uint32_t>> moves;
+    std::uint32_t games() const;
+};
+
+/// Collects positions of finished games and writes them sorted by hash
+class PositionDbBuilder {
+    /// one position of one game
+    struct Record {
+        std::uint64_t hash;
+        /// from | to << 6 | promotion << 12, NoMove after the last move
+        std::uint16_t move;
+        /// 0 - Whites won, 1 - draw, 2 - Blacks won
+        std::uint8_t result;
+    };
+    static constexpr std::uint16_t NoMove = 0xFFFF;
+    std::vector<Record> records;
+
+public:
+    /// replays board's moves from its start position, only "1-0", "0-1" and
+    /// "1/2-1/2" results are taken, returns false for any other. A position
+    /// repeated within the game counts once, with the move first played from it
+    bool addGame(const Chessboard& board, std::string_view result);
+    /// positions collected so far, ones repeated by different games included
+    std::size_t size() const;
+    /// throws runtime_error if file cannot be written
+    void write(const std::string& fileName);
+};
+
+/// Read-only position statistics mapped from a file written by PositionDbBuilder.
+/// A lookup reads one index slot and binary searches a short run of
+/// positions, so it touches a few pages at most
+class PositionDb {
+    MappedFile file;
+    const std::uint8_t* index = nullptr;
+    const std::uint8_t* positions = nullptr;
+    const std::uint8_t* moves = nullptr;
+    unsigned int indexBits = 0;
+    std::uint64_t positionCount = 0;
+    std::uint64_t moveCount = 0;
+
+public:
+    /// throws runtime_error if file is missing or broken
+    explicit PositionDb(const std::string& fileName);
+    /// false if hash is not in the database
+    bool find(std::uint64_t hash, PositionStats& stats) const;
+    bool find(const Chessboard& board, PositionStats& stats) const;
+    std::uint64_t size() const;
+};
+
+typedef std::shared_ptr<PositionDb> PPositionDb;
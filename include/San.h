@@ -0,0 +1,18 @@
+#pragma once
+
+#include "Chessboard.h"
+#include "Move.h"
+
+#include <string>
+#include <string_view>
+
+/// Standard Algebraic Notation as used by PGN, e.g. "Nbd7", "exd6", "e8=Q+", "O-O"
+class San {
+public:
+    /// resolves san against the legal moves of the side to move,
+    /// throws invalid_argument if no move or more than one move fits
+    static Move parse(const Chessboard& board, std::string_view san);
+    /// appends san of a legal move of the side to move to out, check marks are
+    /// left to the caller since they need the position after the move
+    static void write(const Chessboard& board, const Move& move, std::string& out);
+};
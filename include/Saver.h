@@ -3,17 +3,36 @@
 #include "Chessboard.h"
 #include "Figure.h"
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 
+/// Stores a game either as text, one line per figure, or in a compact binary
+/// form: header, 32 bytes of board, counters and the moves played. Loading
+/// tells the two apart by the binary header
 class Saver {
+public:
+    enum Format { Text = 0, Binary };
+
+private:
     std::string fileName;
+    Format format;
     std::string dumpFigure(const PFigure& fig) const;
     PFigure restoreFigure(const std::string& data) const;
+    void saveText(const PChessboard& checkboard, const std::string& target) const;
+    void saveBinary(const PChessboard& checkboard, const std::string& target) const;
+    PChessboard loadText() const;
+    /// reads straight from the mapped file, throws on truncated or foreign data
+    static PChessboard loadBinary(const std::uint8_t* data, std::size_t size);
 
 public:
-    explicit Saver(std::string filename = "./defailtSavefile.txt");
+    explicit Saver(std::string filename = "./defailtSavefile.txt", Format format = Text);
+    /// writes a temporary file next to the savefile and renames it over, so the
+    /// savefile is either the old one or the new one, never a mix
     void saveCheckboard(const PChessboard& checkboard) const;
+    /// either format is accepted regardless of the one used for saving,
+    /// a Journal file is replayed as well
     PChessboard loadCheckboard() const;
 };
 
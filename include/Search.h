@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Chessboard.h"
+#include "Move.h"
+#include "Tablebase.h"
+#include "TimeManager.h"
+
+#include <cstdint>
+#include <memory>
+
+/// Iterative deepening alpha-beta search over material balance
+class Search {
+    PTimeManager timeManager;
+    /// positions found in tables are scored exactly instead of being searched
+    PTablebase tablebase;
+    std::uint64_t nodes;
+    unsigned int completedDepth;
+    int score;
+    Move bestMove;
+    int negamax(const PChessboard& board, unsigned int depth, int alpha, int beta, unsigned int ply);
+    static int evaluate(const PChessboard& board);
+    static PChessboard makeMove(const PChessboard& board, const Move& move);
+
+public:
+    static constexpr int MateScore = 100000;
+
+    explicit Search(PTimeManager timeManager, PTablebase tablebase = nullptr);
+    /// searches until time manager stops us or maxDepth is completed,
+    /// throws if side to move has no moves at all
+    Move think(const PChessboard& board, unsigned int maxDepth = 64);
+    std::uint64_t getNodes() const;
+    unsigned int getDepth() const;
+    int getScore() const;
+};
+
+typedef std::shared_ptr<Search> PSearch;
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Chessboard.h"
+#include "Figure.h"
+#include "MappedFile.h"
+#include "Move.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/// What a table says about a position, for the side to move
+struct TablebaseResult {
+    enum Wdl { Loss = -1, Draw = 0, Win = 1 };
+    Wdl wdl = Draw;
+    /// plies to mate with best play of both sides, 0 for draws
+    unsigned int plies = 0;
+};
+
+/// Distance to mate tables of king and one figure against a lone king: KQK, KRK
+/// and KPK. Positions are indexed as if Whites had the figure, side to move
+/// (0 for the side with the figure), its king, the lone king and the figure
+/// taking 1 + 6 * 3 bits. A value is 1 + plies to mate, odd plies being a win
+/// for the side to move, 0 is a draw and Invalid a position that cannot happen
+namespace TablebaseIndex {
+
+constexpr std::size_t PositionCount = 2 * 64 * 64 * 64;
+constexpr std::uint8_t Draw = 0;
+constexpr std::uint8_t Invalid = 255;
+
+constexpr std::size_t index(bool strongToMove, int strongKing, int weakKing, int figure)
+{
+    return ((std::size_t)(strongToMove ? 0 : 1) * 64 + strongKing) * 64 * 64
+        + (std::size_t)weakKing * 64 + figure;
+}
+
+} // namespace TablebaseIndex
+
+/// Solves the tables by retrograde analysis: mates are found first, then each
+/// pass marks positions one ply further from them, until a pass adds nothing.
+/// Every pass is split between threads over index ranges
+class TablebaseGenerator {
+    unsigned int threads;
+    std::map<FigureType, std::vector<std::uint8_t>> solved;
+
+public:
+    explicit TablebaseGenerator(unsigned int threads = 1);
+    /// KPK needs KQK and KRK for promotions, they are solved first.
+    /// Throws invalid_argument for figures other than queen, rook or pawn
+    const std::vector<std::uint8_t>& solve(FigureType figure);
+    /// packed in blocks, solves the table if it is not yet.
+    /// Throws runtime_error if file cannot be written
+    void write(FigureType figure, const std::string& fileName);
+};
+
+/// Tables written by TablebaseGenerator, mapped from files. A lookup reads
+/// one block's few distinct values and a number of bits pointing to one of them
+class Tablebase {
+public:
+    static constexpr std::size_t BlockSize = 1024;
+
+private:
+    struct Table {
+        std::unique_ptr<MappedFile> file;
+        const std::uint8_t* offsets = nullptr;
+        const std::uint8_t* data = nullptr;
+        std::size_t dataSize = 0;
+    };
+    /// indexed by FigureType
+    std::array<Table, King> tables;
+
+public:
+    /// "KQK.tbs" and alike
+    static std::string fileName(FigureType figure);
+    /// maps the tables found in directory, missing ones are not probed.
+    /// Throws runtime_error if a table is broken
+    explicit Tablebase(const std::string& directory);
+    bool has(FigureType figure) const;
+    /// stored value, see TablebaseIndex, impossible positions get any
+    std::uint8_t value(FigureType figure, std::size_t index) const;
+    /// false if position is not covered: other material, a missing table or castling rights
+    bool probe(const Chessboard& board, TablebaseResult& result) const;
+    /// the quickest mate, a drawing move or the longest resistance,
+    /// false if position is not covered
+    bool bestMove(const Chessboard& board, Move& move) const;
+};
+
+typedef std::shared_ptr<Tablebase> PTablebase;
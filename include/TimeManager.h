@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Figure.h"
+#include "GameClock.h"
+#include "Move.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+/// Splits remaining clock time into per move limits. The soft limit is where we
+/// prefer to stop between iterations, the hard limit aborts a running search
+class TimeManager {
+    typedef std::chrono::steady_clock clock;
+
+    clock::time_point startTime;
+    std::chrono::milliseconds optimum;
+    std::chrono::milliseconds softLimit;
+    std::chrono::milliseconds hardLimit;
+    std::atomic<bool> stopFlag;
+    unsigned int iterations;
+    unsigned int stableIterations;
+    Move lastBest;
+    int lastScore;
+
+public:
+    /// clock is checked once per that many searched nodes
+    static constexpr std::uint64_t PollInterval = 1024;
+
+    TimeManager();
+    /// budget next move of given side from its remaining time
+    void start(const GameClock& gameClock, FigurePlayer side);
+    /// spend exactly given time, nothing is extended or cut
+    void start(std::chrono::milliseconds moveTime);
+    /// feeds results of finished iteration to adjust soft limit
+    void iterationFinished(const Move& best, int score);
+    /// whether there is enough time left to finish one more iteration
+    bool canStartIteration() const;
+    /// cheap enough to be called for every node, reads the clock only every PollInterval nodes
+    bool shouldStop(std::uint64_t nodes);
+    /// may be called from any thread
+    void stop();
+    std::chrono::milliseconds elapsed() const;
+    std::chrono::milliseconds getSoftLimit() const;
+    std::chrono::milliseconds getHardLimit() const;
+};
+
+typedef std::shared_ptr<TimeManager> PTimeManager;
@@ -2,7 +2,9 @@
 
 #include "Chessboard.h"
 #include "Figure.h"
+#include "GameClock.h"
 #include "Point.h"
+#include "PositionDb.h"
 
 #include <list>
 #include <memory>
@@ -16,10 +18,14 @@ public:
     void renderFigures(const PChessboard& checkboard) const;
     int askForAction(bool b, const std::list<std::string>& actions) const;
     PPoint getPoint(const std::string& message) const;
+    FigureType askPromotion() const;
     void renderKillText(char victim, char killer) const;
+    void renderDraw(const std::string& reason) const;
     void renderSelectedInfo(const PFigure& Figure) const;
     void renderMayGoToPath(const PPoints& list) const;
     void renderFreeFigures(const std::set<PFigure>& set) const;
+    void renderClocks(const GameClock& clock) const;
+    void renderPositionStats(const PositionStats& stats) const;
 };
 
 typedef std::shared_ptr<ViewSide> PViewSide;
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/// Random keys for position hashing, generated at compile time so every build
+/// and every saved hash agree
+namespace Zobrist {
+
+/// splitmix64 step, advances state and returns next pseudo random number
+constexpr std::uint64_t next(std::uint64_t& state)
+{
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+struct Keys {
+    /// indexed by BoardSnapshot figure code and square
+    std::array<std::array<std::uint64_t, 64>, 16> figures;
+    /// indexed by BoardSnapshot castling rights
+    std::array<std::uint64_t, 16> castling;
+    /// indexed by file of en passant square
+    std::array<std::uint64_t, 8> enPassant;
+    std::uint64_t blacksTurn;
+};
+
+constexpr Keys buildKeys(std::uint64_t seed)
+{
+    Keys keys{};
+    for (auto& code : keys.figures)
+        for (auto& key : code)
+            key = next(seed);
+    for (auto& key : keys.castling)
+        key = next(seed);
+    for (auto& key : keys.enPassant)
+        key = next(seed);
+    keys.blacksTurn = next(seed);
+    return keys;
+}
+
+inline constexpr Keys keys = buildKeys(0x1C4E55B0A2DULL);
+
+static_assert(keys.figures[1][0] != keys.figures[1][1], "zobrist keys are broken");
+
+} // namespace Zobrist
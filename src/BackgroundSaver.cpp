@@ -0,0 +1,79 @@
+#include <BackgroundSaver.h>
+#include <Chessboard.h>
+#include <Saver.h>
+
+#include <exception>
+#include <stdexcept>
+
+using namespace std;
+
+BackgroundSaver::BackgroundSaver(PSaver s)
+    : saver(std::move(s))
+{
+    if (!saver)
+        throw invalid_argument("Cannot save without a saver");
+    writer = thread(&BackgroundSaver::work, this);
+}
+
+BackgroundSaver::~BackgroundSaver()
+{
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+void BackgroundSaver::save(const Chessboard& board)
+{
+    // the copy shares nothing with the game, so the writer may read it freely
+    auto copy = board.clone();
+    {
+        lock_guard<std::mutex> lock(mutex);
+        pending = std::move(copy);
+    }
+    wake.notify_one();
+}
+
+void BackgroundSaver::flush()
+{
+    unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !pending && !writing; });
+}
+
+vector<string> BackgroundSaver::takeReports()
+{
+    lock_guard<std::mutex> lock(mutex);
+    vector<string> taken;
+    taken.swap(reports);
+    return taken;
+}
+
+void BackgroundSaver::work()
+{
+    unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return pending || stopping; });
+        if (!pending) // stopping with nothing left to write
+            return;
+
+        auto board = std::move(pending);
+        pending = nullptr;
+        writing = true;
+        lock.unlock();
+
+        string report = "Game saved";
+        try {
+            saver->saveCheckboard(board);
+        } catch (std::exception& e) {
+            report = string("Couldn't save the game :( ") + e.what();
+        }
+
+        lock.lock();
+        writing = false;
+        reports.push_back(report);
+        if (!pending)
+            idle.notify_all();
+    }
+}
@@ -0,0 +1,119 @@
+#include <Bench.h>
+#include <Chessboard.h>
+#include <Fen.h>
+#include <Point.h>
+#include <ViewSide.h>
+
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+// openings, castling-rich middlegames and promotion-heavy endgames
+const char* const benchPositions[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2",
+    "r1bqkbnr/pppp1ppp/2n5/1B2p3/4P3/5N2/PPPP1PPP/RNBQK2R b KQkq - 3 3",
+    "rnbqkb1r/pp2pppp/3p1n2/8/3NP3/8/PPP2PPP/RNBQKB1R w KQkq - 1 5",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "r3k2r/2pb1ppp/2pp1q2/p7/1nP1B3/1P2P3/P2N1PPP/R2QK2R w KQkq - 0 14",
+    "r3kb1r/3n1pp1/p6p/2pPp2q/Pp2N3/3B2PP/1PQ2P2/R3K2R w KQkq - 0 1",
+    "r1bq1rk1/pp2b1pp/n1pp1n2/3P1p2/2P1p3/2N1P2N/PP2BPPP/R1BQ1RK1 b - - 2 10",
+    "4rrk1/2p1b1p1/p1p3q1/4p3/2P2n1p/1P1NR2P/PB3PP1/3R1QK1 b - - 2 24",
+    "r3qbrk/6p1/2b2pPp/p3pP1Q/PpPpP2P/3P1B2/2PB3K/R5R1 w - - 16 42",
+    "6k1/1R3p2/6p1/2Bp3p/3P2q1/P7/1P2rQ1K/5R2 b - - 4 44",
+    "7r/2p3k1/1p1p1qp1/1P1Bp3/p1P2r1P/P7/4R3/Q4RK1 w - - 0 36",
+    "3r3k/2r4p/1p1b3q/p4P2/P2Pp3/1B2P3/3BQ1RP/6K1 w - - 3 87",
+    "2r4r/1p4k1/1Pnp4/3Qb1pq/8/4BpPp/5P2/2RR1BK1 w - - 0 42",
+    "2q3r1/1r2pk2/pp3pp1/2pP3p/P1Pb1BbP/1P4Q1/R3NPP1/4R1K1 w - - 2 34",
+    "1r2r2k/1b4q1/pp5p/2pPp1p1/P3Pn2/1P1B1Q1P/2R3P1/4BR1K b - - 1 37",
+    "4k3/8/8/8/8/8/8/4K2R w K - 0 1",
+    "r3k3/8/8/8/8/8/8/4K3 w q - 0 1",
+    "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1",
+    "r3k2r/8/8/8/8/8/8/1R2K2R b Kkq - 0 1",
+    "1r2k2r/8/8/8/8/8/8/R3K2R w KQk - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/1p2k1p1/3p3p/1p1P1P1P/1P2PK2/8/8 w - - 3 54",
+    "8/1n4N1/2k5/8/8/5K2/1N4n1/8 w - - 0 1",
+    "B6b/8/8/8/2K5/4k3/8/b6B w - - 0 1",
+    "7k/RR6/8/8/8/8/rr6/7K w - - 0 1",
+    "K7/8/2n5/1n6/8/8/8/k6N w - - 0 1",
+    "3k4/3pp3/8/8/8/8/3PP3/3K4 w - - 0 1",
+    "8/2k1p3/3pP3/3P2K1/8/8/8/8 w - - 0 1",
+    "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1",
+    "8/5bk1/8/2Pp4/8/1K6/8/8 w - d6 0 1",
+    "8/P1k5/K7/8/8/8/8/8 w - - 0 1",
+    "8/Pk6/8/8/8/8/6Kp/8 w - - 0 1",
+    "n1n5/1Pk5/8/8/8/8/5Kp1/5N1N w - - 0 1",
+    "8/PPPk4/8/8/8/8/4Kppp/8 w - - 0 1",
+    "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+    "2r3k1/1P6/8/8/8/8/1p6/2R3K1 w - - 0 1",
+};
+
+} // namespace
+
+Bench::Bench(unsigned int d)
+    : depth(d)
+{
+}
+
+uint64_t Bench::run(const PViewSide& view) const
+{
+    uint64_t nodes = 0;
+    int index = 0;
+    const int total = sizeof(benchPositions) / sizeof(*benchPositions);
+
+    auto start = chrono::steady_clock::now();
+    for (const auto* fen : benchPositions) {
+        auto positionNodes = perft(loadPosition(fen), depth);
+        nodes += positionNodes;
+
+        ostringstream line;
+        line << "Position " << ++index << "/" << total << ": " << positionNodes;
+        view->renderText(line.str());
+    }
+    auto elapsed
+        = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+
+    ostringstream summary;
+    summary << "===========================\n";
+    summary << "Total time (ms) : " << elapsed << "\n";
+    summary << "Nodes searched  : " << nodes << "\n";
+    summary << "Nodes/second    : " << nodes * 1000 / (elapsed > 0 ? elapsed : 1);
+    view->renderText(summary.str());
+
+    return nodes;
+}
+
+uint64_t Bench::perft(const PChessboard& board, unsigned int d)
+{
+    if (d == 0)
+        return 1;
+
+    const auto moves = board->listMoves(board->getWhitesTurn() ? Whites : Blacks);
+    if (d == 1)
+        return moves.size();
+
+    uint64_t nodes = 0;
+    for (const auto& move : moves) {
+        auto child = board->clone();
+        if (!child->prepareMove(make_shared<Point>(move.getFrom()), make_shared<Point>(move.getTo()),
+                                move.getPromotion()))
+            throw runtime_error("Generated move was rejected: " + move.asString());
+        child->setTurn(!board->getWhitesTurn());
+        nodes += perft(child, d - 1);
+    }
+    return nodes;
+}
+
+PChessboard Bench::loadPosition(const string& fen)
+{
+    return make_shared<Chessboard>(Fen::parse(fen));
+}
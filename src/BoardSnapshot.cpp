@@ -0,0 +1,154 @@
+#include <BoardSnapshot.h>
+#include <Bytes.h>
+#include <Figure.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+uint8_t BoardSnapshot::get(int square) const
+{
+    if (square < 0 || square >= 64)
+        throw out_of_range("Square is out of board");
+    return square % 2 ? squares[square / 2] >> 4 : squares[square / 2] & 0x0F;
+}
+
+void BoardSnapshot::set(int square, uint8_t c)
+{
+    if (square < 0 || square >= 64)
+        throw out_of_range("Square is out of board");
+    auto& pair = squares[square / 2];
+    pair = square % 2 ? (uint8_t)((pair & 0x0F) | c << 4) : (uint8_t)((pair & 0xF0) | (c & 0x0F));
+}
+
+bool BoardSnapshot::isEmpty(int square) const
+{
+    return get(square) == Empty;
+}
+
+FigureType BoardSnapshot::getType(int square) const
+{
+    return static_cast<FigureType>((get(square) - 1) % 8);
+}
+
+FigurePlayer BoardSnapshot::getPlayer(int square) const
+{
+    return get(square) > 8 ? Blacks : Whites;
+}
+
+unsigned int BoardSnapshot::getDeadCount(FigurePlayer player, FigureType type) const
+{
+    return type == King ? 0 : dead[player][type];
+}
+
+void BoardSnapshot::setDeadCount(FigurePlayer player, FigureType type, unsigned int count)
+{
+    if (type == King)
+        throw invalid_argument("King cannot be captured");
+    dead[player][type] = (uint8_t)min(count, 255u);
+}
+
+uint8_t BoardSnapshot::getCastling() const
+{
+    return castling;
+}
+
+bool BoardSnapshot::canCastle(Castling right) const
+{
+    return castling & right;
+}
+
+void BoardSnapshot::setCastling(uint8_t rights)
+{
+    castling = rights;
+}
+
+uint8_t BoardSnapshot::getEnPassant() const
+{
+    return enPassant;
+}
+
+void BoardSnapshot::setEnPassant(uint8_t square)
+{
+    enPassant = square;
+}
+
+bool BoardSnapshot::getWhitesTurn() const
+{
+    return whitesTurn;
+}
+
+void BoardSnapshot::setWhitesTurn(bool w)
+{
+    whitesTurn = w;
+}
+
+uint16_t BoardSnapshot::getHalfmoveClock() const
+{
+    return halfmoveClock;
+}
+
+void BoardSnapshot::setHalfmoveClock(uint16_t h)
+{
+    halfmoveClock = h;
+}
+
+uint32_t BoardSnapshot::getPly() const
+{
+    return ply;
+}
+
+void BoardSnapshot::setPly(uint32_t p)
+{
+    ply = p;
+}
+
+void BoardSnapshot::pack(uint8_t* out) const
+{
+    // squares are already two per byte, the rest goes byte by byte
+    out = copy(squares.begin(), squares.end(), out);
+    for (const auto& side : dead)
+        out = copy(side.begin(), side.end(), out);
+    *out++ = castling;
+    *out++ = enPassant;
+    *out++ = whitesTurn;
+    Bytes::storeLittle(out, halfmoveClock);
+    Bytes::storeLittle(out + 2, ply);
+}
+
+BoardSnapshot BoardSnapshot::unpack(const uint8_t* data)
+{
+    BoardSnapshot snapshot;
+    for (int square = 0; square < 64; ++square) {
+        const uint8_t c = square % 2 ? data[square / 2] >> 4 : data[square / 2] & 0x0F;
+        // only 1 + type and 9 + type are figures
+        if (c % 8 == 7 || c == 8)
+            throw invalid_argument("Got bad formatted snapshot");
+    }
+    copy(data, data + snapshot.squares.size(), snapshot.squares.begin());
+    data += snapshot.squares.size();
+    for (auto& side : snapshot.dead)
+        for (auto& count : side)
+            count = *data++;
+    snapshot.castling = data[0] & 0x0F;
+    snapshot.enPassant = data[1];
+    if (snapshot.enPassant != NoEnPassant && snapshot.enPassant >= 64)
+        throw invalid_argument("Got bad formatted snapshot");
+    snapshot.whitesTurn = data[2] != 0;
+    snapshot.halfmoveClock = Bytes::loadLittle<uint16_t>(data + 3);
+    snapshot.ply = Bytes::loadLittle<uint32_t>(data + 5);
+    return snapshot;
+}
+
+bool BoardSnapshot::operator==(const BoardSnapshot& snapshot) const
+{
+    return squares == snapshot.squares && dead == snapshot.dead && castling == snapshot.castling
+        && enPassant == snapshot.enPassant && whitesTurn == snapshot.whitesTurn
+        && halfmoveClock == snapshot.halfmoveClock && ply == snapshot.ply;
+}
+
+bool BoardSnapshot::operator!=(const BoardSnapshot& snapshot) const
+{
+    return !(*this == snapshot);
+}
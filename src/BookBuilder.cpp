@@ -0,0 +1,230 @@
+#include <BookBuilder.h>
+#include <Bytes.h>
+#include <Chessboard.h>
+#include <Journal.h>
+#include <MappedFile.h>
+#include <Move.h>
+#include <PgnReader.h>
+#include <Point.h>
+#include <PolyglotBook.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+uint64_t peakMemory()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+#if defined(__APPLE__)
+    return (uint64_t)usage.ru_maxrss;
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+double secondsSince(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+string BookBuildStats::asString() const
+{
+    ostringstream s;
+    s << "===========================\n";
+    s << "Games read      : " << games << "\n";
+    s << "Games skipped   : " << skipped << "\n";
+    s << "Positions       : " << positions << "\n";
+    s << "Book entries    : " << entries << "\n";
+    s << "Moves pruned    : " << pruned << "\n";
+    s << "Total time (ms) : " << (uint64_t)(seconds * 1000) << "\n";
+    s << "Peak memory (MB): ";
+    if (peakMemory)
+        s << peakMemory / (1024 * 1024);
+    else
+        s << "unknown";
+    return s.str();
+}
+
+BookBuilder::BookBuilder(
+    PolyglotKeys k, unsigned int t, unsigned int g, unsigned int s, unsigned int p)
+    : keys(k)
+    , threads(max(t, 1u))
+    , minGames(max(g, 1u))
+    , minScore(s)
+    , maxPly(p)
+{
+}
+
+void BookBuilder::addGame(const Chessboard& board, string_view result)
+{
+    // half points of Whites, Blacks get the rest
+    uint32_t whitesScore = 1;
+    if (result == "1-0")
+        whitesScore = 2;
+    else if (result == "0-1")
+        whitesScore = 0;
+
+    Chessboard replay(board.getStartPosition());
+    unsigned int ply = 0;
+    for (const auto& move : board.getMoves()) {
+        if (ply++ == maxPly)
+            break;
+        const auto snapshot = replay.snapshot();
+        const auto key = keys.hash(snapshot);
+        const auto code = PolyglotKeys::encode(snapshot, move);
+        const auto score = snapshot.getWhitesTurn() ? whitesScore : 2 - whitesScore;
+        {
+            auto& shard = shards[key % ShardCount];
+            lock_guard<mutex> guard(shard.lock);
+            auto& moves = shard.positions[key];
+            auto found = find_if(
+                moves.begin(), moves.end(), [code](const MoveStats& i) { return i.move == code; });
+            if (found == moves.end())
+                moves.push_back({code, 1, score});
+            else {
+                ++found->games;
+                found->score += score;
+            }
+        }
+
+        if (!replay.prepareMove(make_shared<Point>(move.getFrom()), make_shared<Point>(move.getTo()),
+                                move.getPromotion()))
+            throw runtime_error("Recorded move cannot be played " + move.asString());
+        replay.setTurn(!replay.getWhitesTurn());
+    }
+    ++games;
+}
+
+void BookBuilder::addFiles(const vector<string>& fileNames)
+{
+    const auto start = chrono::steady_clock::now();
+    const PgnReader reader(threads);
+    vector<string> journals;
+    for (const auto& fileName : fileNames) {
+        MappedFile file(fileName);
+        if (Journal::isJournal(file.getData(), file.getSize())) {
+            journals.push_back(fileName);
+            continue;
+        }
+        const auto read = reader.read(
+            string_view((const char*)file.getData(), file.getSize()),
+            [this](const PgnGame& game) { addGame(*game.board, game.result); });
+        skipped += read.skipped;
+    }
+
+    // a journal is one game, so a thread gets a whole file at a time
+    atomic<size_t> next{0};
+    auto work = [&]() {
+        for (auto i = next++; i < journals.size(); i = next++) {
+            try {
+                MappedFile file(journals[i]);
+                addGame(*Journal::replay(file.getData(), file.getSize(), true), "*");
+            } catch (exception&) {
+                ++skipped;
+            }
+        }
+    };
+    vector<thread> workers;
+    for (unsigned int i = 1; i < threads && i < journals.size(); ++i)
+        workers.emplace_back(work);
+    work();
+    for (auto& worker : workers)
+        worker.join();
+
+    stats.seconds += secondsSince(start);
+}
+
+void BookBuilder::write(const string& fileName)
+{
+    const auto start = chrono::steady_clock::now();
+    const uint32_t maxWeight = 0xFFFF;
+
+    struct Entry {
+        uint64_t key;
+        uint16_t move;
+        uint16_t weight;
+    };
+    vector<Entry> entries;
+    stats.positions = 0;
+    stats.pruned = 0;
+    for (auto& shard : shards) {
+        lock_guard<mutex> guard(shard.lock);
+        stats.positions += shard.positions.size();
+        for (const auto& position : shard.positions) {
+            uint32_t heaviest = 0;
+            for (const auto& move : position.second)
+                heaviest = max(heaviest, move.score);
+
+            for (const auto& move : position.second) {
+                // score is in half points, so 2 * games is everything the mover could get
+                if (move.games < minGames
+                    || (uint64_t)move.score * 100 < (uint64_t)minScore * 2 * move.games) {
+                    ++stats.pruned;
+                    continue;
+                }
+                const auto weight = heaviest > maxWeight
+                    ? (uint64_t)move.score * maxWeight / heaviest
+                    : move.score;
+                entries.push_back({position.first, move.move, (uint16_t)weight});
+            }
+        }
+    }
+    sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    ofstream file(fileName, ios::binary);
+    if (!file.is_open())
+        throw runtime_error("Couldn't write to " + fileName);
+    vector<uint8_t> buffer(entries.size() * PolyglotBook::EntrySize);
+    auto* out = buffer.data();
+    for (const auto& entry : entries) {
+        Bytes::storeBig(out, entry.key);
+        Bytes::storeBig(out + 8, entry.move);
+        Bytes::storeBig(out + 10, entry.weight);
+        Bytes::storeBig(out + 12, (uint32_t)0);
+        out += PolyglotBook::EntrySize;
+    }
+    file.write((const char*)buffer.data(), (streamsize)buffer.size());
+    if (!file.flush())
+        throw runtime_error("Couldn't write to " + fileName);
+
+    stats.entries = entries.size();
+    stats.seconds += secondsSince(start);
+}
+
+BookBuildStats BookBuilder::getStats() const
+{
+    auto result = stats;
+    result.games = games;
+    result.skipped = skipped;
+    result.peakMemory = peakMemory();
+    return result;
+}
@@ -0,0 +1,39 @@
+#include <CaptureLog.h>
+
+#include <stdexcept>
+
+using namespace std;
+
+void CaptureLog::record(unsigned int ply, unsigned int capturedId, unsigned int capturingId,
+                        int square)
+{
+    if (capturedId >= Nobody || square < 0 || square >= 64)
+        throw invalid_argument("Cannot record capture of unknown figure");
+    if (capturingId > Nobody)
+        capturingId = Nobody;
+
+    entries.push_back({ply, (uint8_t)capturedId, (uint8_t)capturingId, (uint8_t)square});
+}
+
+void CaptureLog::clear()
+{
+    entries.clear();
+}
+
+const vector<Capture>& CaptureLog::getEntries() const
+{
+    return entries;
+}
+
+size_t CaptureLog::size() const
+{
+    return entries.size();
+}
+
+const Capture* CaptureLog::findCaptured(unsigned int id) const
+{
+    for (auto i = entries.rbegin(); i != entries.rend(); ++i)
+        if (i->capturedId == id)
+            return &*i;
+    return nullptr;
+}
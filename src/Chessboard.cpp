@@ -1,13 +1,24 @@
 
 
+#include <BoardSnapshot.h>
+#include <CaptureLog.h>
 #include <Chessboard.h>
+#include <Fen.h>
 #include <Figure.h>
 #include <FigureFactory.h>
+#include <Move.h>
+#include <MoveCache.h>
+#include <MoveGenerator.h>
 #include <PathSystem.h>
 #include <Point.h>
+#include <Zobrist.h>
 
+#include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <cstdlib>
 #include <list>
+#include <memory>
 #include <stdexcept>
 
 using namespace std;
@@ -16,6 +27,8 @@ Chessboard::Chessboard()
 {
     m_board.clear();
     m_pathSystem = make_shared<PathSystem>(m_board);
+    positionChanged();
+    restartRecords();
 }
 
 Chessboard::~Chessboard()
@@ -27,124 +40,602 @@ PFigure Chessboard::at(const PPoint& point) const
 {
     if (!point || !point->inBounds())
         return nullptr;
+    return m_squares[Attacks::square(point->getX(), point->getY())];
+}
 
-    for (const auto& item : m_board)
-        if (*(item->getPoint()) == *point)
-            return item;
-    return nullptr;
+PFigure Chessboard::atSquare(int square) const
+{
+    if (square < 0 || square >= 64)
+        return nullptr;
+    return m_squares[square];
+}
+
+PFigure Chessboard::getFigure(unsigned int id) const
+{
+    return id < MaxFigures ? m_figures[id] : nullptr;
+}
+
+int Chessboard::getSquare(unsigned int id) const
+{
+    return id < MaxFigures ? m_figureSquares[id] : -1;
 }
 
-bool Chessboard::prepareMove(const PPoint& from, const PPoint& to)
+bool Chessboard::prepareMove(const PPoint& from, const PPoint& to, FigureType promotion)
 {
     // recheck checkbox for ally figure
     auto figure = at(from);
-    if (!figure)
+    if (!figure || !to)
         return false;
-
-    if (m_pathSystem->getBoard().size() != m_board.size())
-        m_pathSystem->setBoard(m_board);
-
-    if (!m_pathSystem->checkForMovement(figure, to))
+    if (promotion == Pawn || promotion == King)
+        throw invalid_argument("Pawn cannot be promoted to that figure");
+
+    // reuse this turn's list of moves if somebody already asked for it
+    const Move move(*from, *to);
+    const auto* cache = m_moveCaches[figure->getPlayer()].load(memory_order_acquire);
+    const bool legal = cache ? cache->contains(move) : isLegal(move);
+    if (!legal)
         return false;
 
+    // positions before pawn moves, captures and lost castling rights cannot repeat
+    const auto capturesBefore = m_captures.size();
+    const auto castlingBefore = castlingRights();
+    const bool pawnMoved = figure->isPawn();
+    const bool doubleStep = pawnMoved && abs((int)to->getY() - figure->getY()) == 2;
+    const auto skipped = Attacks::square(figure->getX(), (figure->getY() + (int)to->getY()) / 2);
+    // castling onto the own rook or king is recorded as the king's two-square move,
+    // the one listMoves offers, so notation and replays see a castle
+    auto target = at(to);
+    const bool castling = target && target->getPlayer() == figure->getPlayer();
+    const auto& king = castling && target->isKing() ? target : figure;
+    const auto& rook = castling && target->isKing() ? figure : target;
+    const auto kingTo = castling
+        ? Point(king->getX() + (rook->getX() > king->getX() ? 2 : -2), king->getY())
+        : *to;
+    const Move played(castling ? *king->getPoint() : *from, kingTo,
+                      isPromotion(move) ? promotion : Queen);
+    if (m_moves.empty())
+        m_start = snapshot();
+
     performMovement(figure, to);
+    m_enPassant = doubleStep ? skipped : -1;
 
     // make aliases for readability
     const auto side = figure->getPlayer();
     const auto type = figure->getType();
-    const int endY = figure->getPlayer() == Whites ? 7 : 0;
+    const unsigned int endY
+        = side == Whites ? SideTraits<Whites>::promotionRank : SideTraits<Blacks>::promotionRank;
 
     // after the movement we update board figures if needed and check special
     // morphs for pawns
     if (type == Pawn && to->getY() == endY) {
-        PFigure undead;
-        int temp = -1; // get the most valuable from dead list
-        for (const auto& i : m_deadFigures) {
-            if (i->getPlayer() != side)
-                continue;
-            if (i->getType() > temp) {
+        PFigure undead; // bring back a dead figure of wanted type if there is one
+        for (const auto& i : getDeadFigures())
+            if (i->getPlayer() == side && i->getType() == promotion) {
                 undead = i;
-                temp = i->getType();
+                break;
             }
-        }
 
-        if (!undead)
-            undead = FigureFactory::buildQueen(figure->getPlayer());
+        if (!undead) {
+            undead = make_shared<Figure>(*to, promotion, side);
+            registerFigure(undead);
+        }
 
         undead->moved();
         undead->revive();
-        m_deadFigures.remove(undead);
 
         undead->getPoint()->setX(to->getX());
         undead->getPoint()->setY(to->getY());
         m_board.push_back(undead);
-        figure->isCapturedBy(undead);
+        figure->capture();
+        --m_figureCounts[side][Pawn];
+        ++m_figureCounts[side][undead->getType()];
+        m_captures.record(m_ply, figure->getId(), undead->getId(),
+                          Attacks::square(to->getX(), to->getY()));
         m_board.remove(figure);
-        m_deadFigures.push_back(figure);
     }
-    m_pathSystem->setBoard(m_board);
+    ++m_ply;
     /// need to update pathfinding board after
     /// making morphs and castlings
+    positionChanged();
+
+    const bool captured = m_captures.size() != capturesBefore;
+    m_halfmoveClock = pawnMoved || captured ? 0 : m_halfmoveClock + 1;
+    if (pawnMoved || captured || castlingRights() != castlingBefore)
+        m_history.clear();
+    m_history.push_back(m_placementHash);
+    m_moves.push_back(played);
 
     return true;
 }
 
+bool Chessboard::isPromotion(const Move& move) const
+{
+    auto figure = atSquare(Attacks::square(move.getFrom().getX(), move.getFrom().getY()));
+    if (!figure || !figure->isPawn())
+        return false;
+    return move.getTo().getY()
+        == (figure->getPlayer() == Whites ? SideTraits<Whites>::promotionRank
+                                          : SideTraits<Blacks>::promotionRank);
+}
+
+bool Chessboard::isLegal(const Move& move) const
+{
+    auto figure = at(make_shared<Point>(move.getFrom()));
+    if (!figure)
+        return false;
+
+    return m_pathSystem->isLegal(figure, make_shared<Point>(move.getTo()));
+}
+
 bool Chessboard::onePlayerLeft() const
 {
-    auto side = m_board.front()->getPlayer();
-    for (const auto& item : m_board)
-        if (item->getPlayer() != side)
+    auto total = [this](FigurePlayer side) {
+        unsigned int count = 0;
+        for (auto i : m_figureCounts[side])
+            count += i;
+        return count;
+    };
+    return !total(Whites) || !total(Blacks);
+}
+
+unsigned int Chessboard::getFigureCount(FigurePlayer side, FigureType type) const
+{
+    return m_figureCounts[side][type];
+}
+
+unsigned int Chessboard::getHalfmoveClock() const
+{
+    return m_halfmoveClock;
+}
+
+bool Chessboard::isInCheck(FigurePlayer side) const
+{
+    return m_pathSystem->isInCheck(side);
+}
+
+bool Chessboard::isAttacked(int square, FigurePlayer side) const
+{
+    if (square < 0 || square >= 64)
+        throw invalid_argument("Square is out of board");
+    return m_pathSystem->isAttacked(square, side);
+}
+
+Bitboard Chessboard::attackersTo(int square) const
+{
+    if (square < 0 || square >= 64)
+        throw invalid_argument("Square is out of board");
+    return m_pathSystem->attackersTo(square);
+}
+
+bool Chessboard::isFiftyMoveRule() const
+{
+    return m_halfmoveClock >= 100;
+}
+
+bool Chessboard::hasInsufficientMaterial() const
+{
+    unsigned int minors = 0;
+    for (const auto& side : m_figureCounts) {
+        if (side[Pawn] || side[Rook] || side[Queen])
             return false;
-    return true;
+        minors += side[Knight] + side[Bishop];
+    }
+    return minors <= 1;
 }
 
 void Chessboard::initialize()
 {
-    if (!m_board.empty() || !m_deadFigures.empty())
+    if (!m_board.empty() || m_captures.size())
         destroy();
     auto blacks = FigureFactory::buildSide(FigurePlayer::Blacks);
     auto whites = FigureFactory::buildSide(FigurePlayer::Whites);
 
     m_board.splice(m_board.end(), whites);
     m_board.splice(m_board.end(), blacks);
+    for (const auto& item : m_board)
+        registerFigure(item);
+    positionChanged();
+    restartRecords();
 }
 
 void Chessboard::destroy()
 {
     m_board.clear();
-    m_deadFigures.clear();
+    m_captures.clear();
+    m_ply = 0;
+    m_enPassant = -1;
+    m_figures.fill(nullptr);
+    positionChanged();
+    restartRecords();
+}
+
+void Chessboard::registerFigure(const PFigure& fig)
+{
+    auto id = fig->getId();
+    if (id < MaxFigures && (!m_figures[id] || m_figures[id] == fig)) {
+        m_figures[id] = fig;
+        return;
+    }
+
+    for (id = 0; id < MaxFigures; ++id)
+        if (!m_figures[id]) {
+            fig->setId(id);
+            m_figures[id] = fig;
+            return;
+        }
+    throw runtime_error("Too many figures for one board");
+}
+
+void Chessboard::positionChanged()
+{
+    dropMoveCaches();
+
+    m_squares.fill(nullptr);
+    m_figureSquares.fill(-1);
+    m_placementHash = 0;
+    for (const auto& item : m_board) {
+        const auto square = Attacks::square(item->getX(), item->getY());
+        m_squares[square] = item;
+        m_figureSquares[item->getId()] = square;
+        m_placementHash
+            ^= Zobrist::keys.figures[BoardSnapshot::code(item->getType(), item->getPlayer())][square];
+    }
+    m_placementHash ^= Zobrist::keys.castling[castlingRights()];
+    // en passant square only makes a position different if somebody can use it
+    if (m_enPassant >= 0) {
+        const auto capturer = m_enPassant / 8 == 2 ? Blacks : Whites;
+        const auto victim = capturer == Whites ? Blacks : Whites;
+        auto attackers = Attacks::pawn[victim][m_enPassant];
+        while (attackers) {
+            const auto& figure = m_squares[Attacks::popLowest(attackers)];
+            if (figure && figure->isPawn() && figure->getPlayer() == capturer) {
+                m_placementHash ^= Zobrist::keys.enPassant[m_enPassant % 8];
+                break;
+            }
+        }
+    }
+
+    if (m_pathSystem) {
+        m_pathSystem->setBoard(m_board);
+        m_pathSystem->setEnPassant(m_enPassant);
+    }
+}
+
+vector<Move> Chessboard::listMoves(FigurePlayer side) const
+{
+    static constexpr FigureType promotions[] = {Queen, Rook, Bishop, Knight};
+
+    vector<Move> moves;
+    for (const auto& i : canMoveFrom(side)) {
+        const auto& figure = i.first;
+        const Move move(*figure->getPoint(), *i.second);
+        // castling with a rook onto the king repeats the king's own move
+        auto target = at(i.second);
+        if (figure->isRook() && target && target->isKing() && target->getPlayer() == side)
+            continue;
+
+        if (!isPromotion(move)) {
+            moves.push_back(move);
+            continue;
+        }
+        for (auto type : promotions)
+            moves.emplace_back(*figure->getPoint(), *i.second, type);
+    }
+    return moves;
+}
+
+MoveGenerator Chessboard::generateMoves(FigurePlayer side) const
+{
+    return MoveGenerator(*this, side);
+}
+
+bool Chessboard::hasAnyLegalMove(FigurePlayer side) const
+{
+    if (const auto* cache = m_moveCaches[side].load(memory_order_acquire))
+        return !cache->getMoves().empty();
+
+    Move move;
+    return generateMoves(side).next(move);
+}
+
+Bitboard Chessboard::occupancy(FigurePlayer side) const
+{
+    Bitboard squares = 0;
+    for (unsigned int id = 0; id < MaxFigures; ++id)
+        if (m_figureSquares[id] >= 0 && m_figures[id]->getPlayer() == side)
+            squares |= Bitboard(1) << m_figureSquares[id];
+    return squares;
+}
+
+Bitboard Chessboard::buildTargets(const PFigure& figure) const
+{
+    return m_pathSystem->buildSquares(figure);
+}
+
+bool Chessboard::keepsKingSafe(const PFigure& figure, int to) const
+{
+    return m_pathSystem->keepsKingSafe(figure, to);
+}
+
+int Chessboard::getEnPassant() const
+{
+    return m_enPassant;
+}
+
+void Chessboard::setEnPassant(int square)
+{
+    m_enPassant = square >= 0 && square < 64 ? square : -1;
+    positionChanged();
+    m_history.back() = m_placementHash;
+}
+
+const MoveCache& Chessboard::movesOf(FigurePlayer side) const
+{
+    auto& slot = m_moveCaches[side];
+    if (const auto* cache = slot.load(memory_order_acquire))
+        return *cache;
+
+    // readers may race to build the list, the first one to publish it wins
+    auto built = make_unique<MoveCache>();
+    built->fill(m_pathSystem->getListOfAvailableMoves(side));
+    const MoveCache* expected = nullptr;
+    if (!slot.compare_exchange_strong(expected, built.get(), memory_order_acq_rel))
+        return *expected;
+    return *built.release();
+}
+
+void Chessboard::dropMoveCaches()
+{
+    for (auto& slot : m_moveCaches)
+        delete slot.exchange(nullptr);
 }
 
 // save-load block
 
-Chessboard::Chessboard(const PFigures& figures)
+Chessboard::Chessboard(const PFigures& figures, const CaptureLog& captures, unsigned int ply)
+    : m_captures(captures)
+    , m_ply(ply)
 {
     for (const auto& item : figures) {
+        registerFigure(item);
         if (item->isAlive())
             m_board.push_back(item);
-        else
-            m_deadFigures.push_back(item);
+        else if (!m_captures.findCaptured(item->getId()))
+            m_captures.record(0, item->getId(), CaptureLog::Nobody,
+                              Attacks::square(item->getX(), item->getY()));
     }
     m_pathSystem = make_shared<PathSystem>(m_board);
+    positionChanged();
+    restartRecords();
 }
 
 PFigures Chessboard::getAllFigures() const
 {
     PFigures out;
     out.insert(out.end(), m_board.begin(), m_board.end());
-    out.insert(out.end(), m_deadFigures.begin(), m_deadFigures.end());
+    out.splice(out.end(), getDeadFigures());
 
     return out;
 }
 
+PFigures Chessboard::getDeadFigures() const
+{
+    PFigures out;
+    bitset<MaxFigures> listed;
+    for (const auto& i : m_captures.getEntries()) {
+        const auto& figure = m_figures[i.capturedId];
+        if (!figure || figure->isAlive() || listed.test(i.capturedId))
+            continue;
+        listed.set(i.capturedId);
+        out.push_back(figure);
+    }
+    return out;
+}
+
+unsigned int Chessboard::getPly() const
+{
+    return m_ply;
+}
+
+const vector<Move>& Chessboard::getMoves() const
+{
+    return m_moves;
+}
+
+BoardSnapshot Chessboard::getStartPosition() const
+{
+    return m_moves.empty() ? snapshot() : m_start;
+}
+
+void Chessboard::setMoves(const BoardSnapshot& start, vector<Move> moves)
+{
+    m_start = start;
+    m_moves = std::move(moves);
+}
+
+const CaptureLog& Chessboard::getCaptures() const
+{
+    return m_captures;
+}
+
 void Chessboard::addFigure(PFigure fig)
 {
+    registerFigure(fig);
     m_board.push_back(fig);
+    positionChanged();
+    restartRecords();
 }
 
 void Chessboard::addDeadFigure(PFigure fig)
 {
-    m_deadFigures.push_back(fig);
+    registerFigure(fig);
+    if (fig->isAlive())
+        fig->capture();
+    m_captures.record(m_ply, fig->getId(), CaptureLog::Nobody,
+                      Attacks::square(fig->getX(), fig->getY()));
+}
+
+shared_ptr<Chessboard> Chessboard::clone() const
+{
+    // figures are shared between boards, so every one of them is rebuilt
+    PFigures figures;
+    for (const auto& item : getAllFigures())
+        figures.push_back(make_shared<Figure>(*item));
+
+    auto copy = make_shared<Chessboard>(figures, m_captures, m_ply);
+    copy->setTurn(whitesTurn);
+    copy->setEnPassant(m_enPassant);
+    copy->m_history = m_history;
+    copy->m_moves = m_moves;
+    copy->m_start = m_start;
+    copy->m_halfmoveClock = m_halfmoveClock;
+    return copy;
+}
+
+uint8_t Chessboard::castlingRights() const
+{
+    auto ready = [this](unsigned int x, unsigned int y) {
+        auto figure = atSquare(Attacks::square(x, y));
+        return figure && figure->isReadyForCastling();
+    };
+    typedef SideTraits<Whites> WhitesTraits;
+    typedef SideTraits<Blacks> BlacksTraits;
+
+    uint8_t castling = 0;
+    if (ready(WhitesTraits::kingFile, WhitesTraits::homeRank)) {
+        if (ready(WhitesTraits::kingRookFile, WhitesTraits::homeRank))
+            castling |= BoardSnapshot::WhitesKingSide;
+        if (ready(WhitesTraits::queenRookFile, WhitesTraits::homeRank))
+            castling |= BoardSnapshot::WhitesQueenSide;
+    }
+    if (ready(BlacksTraits::kingFile, BlacksTraits::homeRank)) {
+        if (ready(BlacksTraits::kingRookFile, BlacksTraits::homeRank))
+            castling |= BoardSnapshot::BlacksKingSide;
+        if (ready(BlacksTraits::queenRookFile, BlacksTraits::homeRank))
+            castling |= BoardSnapshot::BlacksQueenSide;
+    }
+    return castling;
+}
+
+void Chessboard::restartRecords()
+{
+    for (auto& side : m_figureCounts)
+        side.fill(0);
+    for (const auto& item : m_board)
+        ++m_figureCounts[item->getPlayer()][item->getType()];
+
+    m_halfmoveClock = 0;
+    m_history.assign(1, m_placementHash);
+    m_moves.clear();
+}
+
+uint64_t Chessboard::getHash() const
+{
+    return whitesTurn ? m_placementHash : m_placementHash ^ Zobrist::keys.blacksTurn;
+}
+
+unsigned int Chessboard::repetitions() const
+{
+    // turns alternate, so only every second entry has the same side to move
+    unsigned int count = 0;
+    for (size_t i = m_history.size() - 1; i >= 2; i -= 2)
+        if (m_history[i - 2] == m_history.back())
+            ++count;
+    return count;
+}
+
+bool Chessboard::isRepetition() const
+{
+    return repetitions() >= 1;
+}
+
+bool Chessboard::isThreefoldRepetition() const
+{
+    return repetitions() >= 2;
+}
+
+BoardSnapshot Chessboard::snapshot() const
+{
+    BoardSnapshot out;
+    for (const auto& item : m_board)
+        out.set(Attacks::square(item->getX(), item->getY()),
+                BoardSnapshot::code(item->getType(), item->getPlayer()));
+
+    for (const auto& item : getDeadFigures())
+        out.setDeadCount(item->getPlayer(), item->getType(),
+                         out.getDeadCount(item->getPlayer(), item->getType()) + 1);
+
+    out.setCastling(castlingRights());
+    out.setEnPassant(m_enPassant < 0 ? BoardSnapshot::NoEnPassant : (uint8_t)m_enPassant);
+    out.setWhitesTurn(whitesTurn);
+    out.setPly(m_ply);
+    out.setHalfmoveClock((uint16_t)min(m_halfmoveClock, 0xFFFFu));
+    return out;
+}
+
+void Chessboard::restore(const BoardSnapshot& snapshot)
+{
+    destroy();
+
+    for (int square = 0; square < 64; ++square) {
+        if (snapshot.isEmpty(square))
+            continue;
+        const auto type = snapshot.getType(square);
+        const auto player = snapshot.getPlayer(square);
+        const unsigned int x = square % 8, y = square / 8;
+        const auto homeRank = player == Whites ? SideTraits<Whites>::homeRank
+                                               : SideTraits<Blacks>::homeRank;
+        const auto kingSide = player == Whites ? BoardSnapshot::WhitesKingSide
+                                               : BoardSnapshot::BlacksKingSide;
+        const auto queenSide = player == Whites ? BoardSnapshot::WhitesQueenSide
+                                                : BoardSnapshot::BlacksQueenSide;
+
+        // castling and double pawn step both depend on figure having not moved yet
+        bool untouched = true;
+        if (type == Pawn)
+            untouched = y == homeRank + (player == Whites ? 1 : -1);
+        else if (type == King)
+            untouched = y == homeRank && x == SideTraits<Whites>::kingFile
+                && (snapshot.getCastling() & (kingSide | queenSide));
+        else if (type == Rook)
+            untouched = y == homeRank
+                && ((x == SideTraits<Whites>::kingRookFile && snapshot.canCastle(kingSide))
+                    || (x == SideTraits<Whites>::queenRookFile && snapshot.canCastle(queenSide)));
+
+        auto figure = make_shared<Figure>(Point(x, y), type, player, untouched ? 0 : 1);
+        registerFigure(figure);
+        m_board.push_back(figure);
+    }
+
+    // captured figures still matter for promotions
+    for (auto player : {Whites, Blacks})
+        for (auto type : {Pawn, Rook, Knight, Bishop, Queen})
+            for (unsigned int i = 0; i < snapshot.getDeadCount(player, type); ++i)
+                addDeadFigure(make_shared<Figure>(Point(0, 0), type, player, 1, true));
+
+    whitesTurn = snapshot.getWhitesTurn();
+    m_ply = snapshot.getPly();
+    m_enPassant
+        = snapshot.getEnPassant() == BoardSnapshot::NoEnPassant ? -1 : snapshot.getEnPassant();
+    positionChanged();
+    restartRecords();
+    m_halfmoveClock = snapshot.getHalfmoveClock();
+}
+
+Chessboard::Chessboard(const BoardSnapshot& snapshot)
+    : Chessboard()
+{
+    restore(snapshot);
+}
+
+void Chessboard::loadFen(string_view fen)
+{
+    restore(Fen::parse(fen));
+}
+
+string Chessboard::toFen() const
+{
+    return Fen::write(snapshot());
 }
 
 PFigures Chessboard::getBoard() const
@@ -168,6 +659,19 @@ void Chessboard::performMovement(const PFigure& figure, const PPoint& to)
         throw invalid_argument("Cannot perform movement on nullptr");
 
     auto possibleFigure = at(to);
+    const auto target = Attacks::square(to->getX(), to->getY());
+    if (figure->isPawn() && !possibleFigure && target == m_enPassant
+        && (int)to->getX() != figure->getX()) {
+        // en passant: the captured pawn stands next to us, not on the target
+        possibleFigure = atSquare(Attacks::square(to->getX(), figure->getY()));
+        possibleFigure->capture();
+        possibleFigure->moved();
+        --m_figureCounts[possibleFigure->getPlayer()][Pawn];
+        m_captures.record(m_ply, possibleFigure->getId(), figure->getId(),
+                          Attacks::square(to->getX(), figure->getY()));
+        m_board.remove(possibleFigure);
+        possibleFigure = nullptr;
+    }
     if (figure->isKing()
         && !possibleFigure
         /// if we move with a king and
@@ -187,10 +691,12 @@ void Chessboard::performMovement(const PFigure& figure, const PPoint& to)
 
     if (possibleFigure) {
         if (possibleFigure->getPlayer() != figure->getPlayer()) {
-            possibleFigure->isCapturedBy(figure);
+            possibleFigure->capture();
             possibleFigure->moved();
+            --m_figureCounts[possibleFigure->getPlayer()][possibleFigure->getType()];
+            m_captures.record(m_ply, possibleFigure->getId(), figure->getId(),
+                              Attacks::square(to->getX(), to->getY()));
             m_board.remove(possibleFigure);
-            m_deadFigures.push_back(possibleFigure);
 
         } else { /// else we castle
             PFigure king, rook;
@@ -217,9 +723,23 @@ void Chessboard::performMovement(const PFigure& figure, const PPoint& to)
     figure->moved();
 }
 
-multimap<PFigure, PPoint> Chessboard::canMoveFrom(FigurePlayer side) const
+const multimap<PFigure, PPoint>& Chessboard::canMoveFrom(FigurePlayer side) const
 {
-    if (m_pathSystem->getBoard().size() != m_board.size())
-        m_pathSystem->setBoard(m_board);
-    return m_pathSystem->getListOfAvailableMoves(side);
+    return movesOf(side).getMoves();
+}
+
+PPoints Chessboard::getPath(const PPoint& from) const
+{
+    auto figure = at(from);
+    if (!figure)
+        return {};
+
+    auto targets = movesOf(figure->getPlayer()).getTargets(*from);
+
+    PPoints path;
+    while (targets) {
+        auto square = Attacks::popLowest(targets);
+        path.push_back(make_shared<Point>(square % 8, square / 8));
+    }
+    return path;
 }
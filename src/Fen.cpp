@@ -0,0 +1,192 @@
+#include <Fen.h>
+
+#include <charconv>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const char figureLetters[] = "PRNBQK";
+
+[[noreturn]] void badFen(string_view fen)
+{
+    throw invalid_argument("Got bad formatted position: " + string(fen));
+}
+
+int figureCode(char ch)
+{
+    const bool white = ch >= 'A' && ch <= 'Z';
+    const char upper = white ? ch : (char)(ch - 'a' + 'A');
+    for (int type = Pawn; type <= King; ++type)
+        if (figureLetters[type] == upper)
+            return BoardSnapshot::code((FigureType)type, white ? Whites : Blacks);
+    return BoardSnapshot::Empty;
+}
+
+/// next space separated field, empty when text is over
+string_view nextField(string_view& text)
+{
+    const auto begin = text.find_first_not_of(' ');
+    if (begin == string_view::npos) {
+        text = {};
+        return {};
+    }
+    text.remove_prefix(begin);
+    const auto end = min(text.find(' '), text.size());
+    auto field = text.substr(0, end);
+    text.remove_prefix(end);
+    return field;
+}
+
+template <typename T>
+bool parseNumber(string_view field, T& value)
+{
+    auto result = from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == errc() && result.ptr == field.data() + field.size();
+}
+
+} // namespace
+
+BoardSnapshot Fen::parse(string_view fen)
+{
+    BoardSnapshot snapshot;
+    auto rest = fen;
+
+    // ranks go from the 8th down, files from a to h
+    int x = 0, y = 7;
+    unsigned int kings[2] = {0, 0};
+    for (char ch : nextField(rest)) {
+        if (ch == '/') {
+            if (x != 8 || y == 0)
+                badFen(fen);
+            x = 0;
+            --y;
+        } else if (ch >= '1' && ch <= '8') {
+            x += ch - '0';
+            if (x > 8)
+                badFen(fen);
+        } else {
+            const auto code = figureCode(ch);
+            if (code == BoardSnapshot::Empty || x >= 8)
+                badFen(fen);
+            snapshot.set(y * 8 + x++, (uint8_t)code);
+            if (code == BoardSnapshot::code(King, Whites))
+                ++kings[Whites];
+            else if (code == BoardSnapshot::code(King, Blacks))
+                ++kings[Blacks];
+        }
+    }
+    if (x != 8 || y != 0 || kings[Whites] != 1 || kings[Blacks] != 1)
+        badFen(fen);
+
+    const auto turn = nextField(rest);
+    if (turn != "w" && turn != "b")
+        badFen(fen);
+    snapshot.setWhitesTurn(turn == "w");
+
+    const auto castling = nextField(rest);
+    uint8_t rights = 0;
+    if (castling != "-" && !castling.empty()) {
+        for (char ch : castling) {
+            switch (ch) {
+            case 'K':
+                rights |= BoardSnapshot::WhitesKingSide;
+                break;
+            case 'Q':
+                rights |= BoardSnapshot::WhitesQueenSide;
+                break;
+            case 'k':
+                rights |= BoardSnapshot::BlacksKingSide;
+                break;
+            case 'q':
+                rights |= BoardSnapshot::BlacksQueenSide;
+                break;
+            default:
+                badFen(fen);
+            }
+        }
+    }
+    snapshot.setCastling(rights);
+
+    const auto enPassant = nextField(rest);
+    if (enPassant != "-" && !enPassant.empty()) {
+        // the square is left behind by a pawn of the side that just moved
+        const char rank = snapshot.getWhitesTurn() ? '6' : '3';
+        if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h'
+            || enPassant[1] != rank)
+            badFen(fen);
+        snapshot.setEnPassant((uint8_t)((enPassant[1] - '1') * 8 + enPassant[0] - 'a'));
+    }
+
+    uint16_t halfmoveClock = 0;
+    const auto halfmoves = nextField(rest);
+    if (!halfmoves.empty() && !parseNumber(halfmoves, halfmoveClock))
+        badFen(fen);
+    snapshot.setHalfmoveClock(halfmoveClock);
+
+    uint32_t fullmove = 1;
+    const auto fullmoves = nextField(rest);
+    if (!fullmoves.empty() && !parseNumber(fullmoves, fullmove))
+        badFen(fen);
+    if (!nextField(rest).empty())
+        badFen(fen);
+    // move numbers start from one, some writers put zero there anyway
+    snapshot.setPly(2 * (fullmove ? fullmove - 1 : 0) + (snapshot.getWhitesTurn() ? 0 : 1));
+
+    return snapshot;
+}
+
+string Fen::write(const BoardSnapshot& snapshot)
+{
+    string fen;
+    fen.reserve(90);
+
+    for (int y = 7; y >= 0; --y) {
+        int empty = 0;
+        for (int x = 0; x < 8; ++x) {
+            const int square = y * 8 + x;
+            if (snapshot.isEmpty(square)) {
+                ++empty;
+                continue;
+            }
+            if (empty)
+                fen += (char)('0' + empty);
+            empty = 0;
+            const char letter = figureLetters[snapshot.getType(square)];
+            fen += snapshot.getPlayer(square) == Whites ? letter : (char)(letter - 'A' + 'a');
+        }
+        if (empty)
+            fen += (char)('0' + empty);
+        if (y)
+            fen += '/';
+    }
+
+    fen += snapshot.getWhitesTurn() ? " w " : " b ";
+
+    if (!snapshot.getCastling())
+        fen += '-';
+    if (snapshot.canCastle(BoardSnapshot::WhitesKingSide))
+        fen += 'K';
+    if (snapshot.canCastle(BoardSnapshot::WhitesQueenSide))
+        fen += 'Q';
+    if (snapshot.canCastle(BoardSnapshot::BlacksKingSide))
+        fen += 'k';
+    if (snapshot.canCastle(BoardSnapshot::BlacksQueenSide))
+        fen += 'q';
+
+    fen += ' ';
+    const auto enPassant = snapshot.getEnPassant();
+    if (enPassant == BoardSnapshot::NoEnPassant) {
+        fen += '-';
+    } else {
+        fen += (char)('a' + enPassant % 8);
+        fen += (char)('1' + enPassant / 8);
+    }
+
+    fen += ' ';
+    fen += to_string(snapshot.getHalfmoveClock());
+    fen += ' ';
+    fen += to_string(snapshot.getPly() / 2 + 1);
+    return fen;
+}
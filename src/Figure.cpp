@@ -11,38 +11,40 @@ Figure::Figure(const Figure& figure)
           figure.getType(),
           figure.getPlayer(),
           figure.getMovesCount(),
-          figure.getKilledBy())
+          !figure.isAlive())
 {
+    id = figure.getId();
 }
 
-Figure::Figure(Point a, FigureType b, FigurePlayer c, unsigned int moves, PFigure k)
+Figure::Figure(Point a, FigureType b, FigurePlayer c, unsigned int moves, bool k)
     : position(make_shared<Point>(a))
-    , killedBy(std::move(k))
+    , captured(k)
     , player(c)
     , type(b)
     , movesMade(moves)
+    , id(NoId)
 {
 }
 
 Figure& Figure::operator=(const Figure& b)
 {
     position = make_shared<Point>(*b.position.get());
-    killedBy = b.killedBy;
+    captured = b.captured;
     player = b.player;
     type = b.type;
     movesMade = b.movesMade;
+    id = b.id;
     return *this;
 }
 
 Figure::~Figure()
 {
-    killedBy = nullptr;
     position = nullptr;
 }
 
 bool Figure::isAlive() const
 {
-    return killedBy == nullptr;
+    return !captured;
 }
 
 FigureType Figure::getType() const
@@ -60,11 +62,6 @@ PPoint Figure::getPoint() const
     return position;
 }
 
-PFigure Figure::getKilledBy() const
-{
-    return killedBy;
-}
-
 char Figure::asChar() const
 {
     char out = ' ';
@@ -94,7 +91,7 @@ char Figure::asChar() const
 
 void Figure::revive()
 {
-    killedBy = nullptr;
+    captured = false;
 }
 
 unsigned int Figure::getMovesCount() const
@@ -102,6 +99,16 @@ unsigned int Figure::getMovesCount() const
     return movesMade;
 }
 
+unsigned int Figure::getId() const
+{
+    return id;
+}
+
+void Figure::setId(unsigned int i)
+{
+    id = i;
+}
+
 void Figure::moved()
 {
     ++movesMade;
@@ -142,10 +149,10 @@ bool Figure::isKing() const
     return type == FigureType::King;
 }
 
-void Figure::isCapturedBy(const PFigure& by)
+void Figure::capture()
 {
-    if (!killedBy)
-        killedBy = by;
+    if (!captured)
+        captured = true;
     else
         throw std::invalid_argument("What is dead may never die");
 }
@@ -1,75 +1,144 @@
+#include <BackgroundSaver.h>
 #include <Chessboard.h>
 #include <Figure.h>
 #include <Game.h>
+#include <GameClock.h>
+#include <Journal.h>
+#include <Move.h>
+#include <PgnWriter.h>
 #include <Point.h>
+#include <PolyglotBook.h>
+#include <PositionDb.h>
 #include <Saver.h>
+#include <Search.h>
+#include <Tablebase.h>
+#include <TimeManager.h>
 #include <ViewSide.h>
 
+#include <bitset>
+#include <chrono>
+#include <ctime>
+#include <fstream>
 #include <list>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 
 using namespace std;
 
-Game::Game(PViewSide v, PSaver s)
+namespace {
+const chrono::milliseconds untimedEngineMove(1000);
+} // namespace
+
+Game::Game(PViewSide v, PSaver s, PGameClock c, PJournal j, string p, PPositionDb d,
+           PPolyglotBook b, PTablebase t)
     : view(std::move(v))
     , saver(std::move(s))
+    , journal(std::move(j))
+    , pgnFile(std::move(p))
+    , positionDb(std::move(d))
+    , book(std::move(b))
+    , tablebase(std::move(t))
+    , gameClock(std::move(c))
 {
+    if (saver)
+        backgroundSaver = make_shared<BackgroundSaver>(saver);
     checkboard = make_shared<Chessboard>();
+    timeManager = make_shared<TimeManager>();
+    search = make_shared<Search>(timeManager, tablebase);
+}
+
+GameResult Game::run()
+{
+    const auto result = play();
+    recordGame(result);
+    return result;
+}
+
+unsigned int Game::getBookHits() const
+{
+    return bookHits;
 }
 
-bool Game::run()
+GameResult Game::play()
 {
     checkboard->initialize();
+    autosave(true);
+    if (gameClock)
+        gameClock->reset();
 
     while (!checkboard->onePlayerLeft()) {
+        renderSaveReports();
         view->renderFigures(checkboard);
+        PositionStats stats;
+        if (positionDb && positionDb->find(*checkboard, stats))
+            view->renderPositionStats(stats);
 
-        auto availableMoves
-            = checkboard->canMoveFrom(checkboard->getWhitesTurn() ? Whites : Blacks);
-        if (availableMoves.empty())
-            break;
+        const auto side = checkboard->getWhitesTurn() ? Whites : Blacks;
+        if (!checkboard->hasAnyLegalMove(side)) {
+            if (checkboard->isInCheck(side))
+                break;
+            view->renderDraw("stalemate");
+            return Draw;
+        }
+
+        if (checkboard->isThreefoldRepetition()) {
+            view->renderDraw("threefold repetition");
+            return Draw;
+        }
+        if (checkboard->isFiftyMoveRule()) {
+            view->renderDraw("fifty-move rule");
+            return Draw;
+        }
+        if (checkboard->hasInsufficientMaterial()) {
+            view->renderDraw("insufficient material");
+            return Draw;
+        }
+
+        if (gameClock) {
+            gameClock->start(side);
+            view->renderClocks(*gameClock);
+        }
 
-        static const list<string> actions = {"Move", "Save", "Load", "Restart", "Quit"};
+        static const list<string> actions
+            = {"Move", "Engine move", "Save", "Load", "Restart", "Quit"};
         auto response = view->askForAction(checkboard->getWhitesTurn(), actions);
         switch (response) {
-        case 1:
-            try {
-                saver->saveCheckboard(checkboard);
-                view->renderText("Game saved");
-            } catch (std::exception& e) {
-                view->renderText("Couldn't save the game :(");
-                view->renderText(e.what());
-            }
+        case 2:
+            // the copy is taken now, the result is reported on one of the next turns
+            backgroundSaver->save(*checkboard);
+            view->renderText("Saving the game");
             continue;
         case 0: {
             set<PFigure> freeFigures;
-            for (const auto& i : availableMoves)
+            for (const auto& i : checkboard->canMoveFrom(side))
                 freeFigures.insert(i.first);
 
             view->renderFreeFigures(freeFigures);
             auto figure = selectFigure(freeFigures);
 
-            PPoints path;
-            for (const auto& i : availableMoves)
-                if (*i.first == *figure && *(i.first->getPoint()) == *(figure->getPoint()))
-                    path.push_back(i.second);
-
+            auto path = checkboard->getPath(figure->getPoint());
             while (path.empty()) {
                 view->renderText("No possible turns, select another figure");
                 figure = selectFigure(freeFigures);
-                for (const auto& i : availableMoves)
-                    if (*i.first == *figure && *(i.first->getPoint()) == *(figure->getPoint()))
-                        path.push_back(i.second);
+                path = checkboard->getPath(figure->getPoint());
             }
 
             auto from = figure->getPoint();
             view->renderSelectedInfo(figure);
             view->renderMayGoToPath(path);
 
+            // only legal promotions are worth asking about
+            auto promotion = [&](const PPoint& target) {
+                const Move move(*from, *target);
+                return checkboard->isPromotion(move) && checkboard->isLegal(move)
+                    ? view->askPromotion()
+                    : Queen;
+            };
+
             auto to = view->getPoint("Enter point to where we move: (0-7 0-7)");
             auto possibleFigure = checkboard->at(to);
-            while (!checkboard->prepareMove(from, to)) {
+            while (!checkboard->prepareMove(from, to, promotion(to))) {
                 view->renderText("Cannot move to that point! try another");
                 to = view->getPoint("to where we move: (0-7 0-7)");
                 possibleFigure = checkboard->at(to);
@@ -79,32 +148,136 @@ bool Game::run()
             else
                 view->renderText("Move completed");
 
+            if (!punchClock(side))
+                goto finish_game;
         } break;
-        case 2:
+        case 1: {
+            Move move;
+            // endgames in tables and book moves are played instantly
+            const char* instant = nullptr;
+            if (tablebase && tablebase->bestMove(*checkboard, move)) {
+                instant = "tablebase";
+            } else if (book && book->pick(*checkboard, move)) {
+                instant = "book";
+                ++bookHits;
+            } else {
+                if (gameClock)
+                    timeManager->start(*gameClock, side);
+                else
+                    timeManager->start(untimedEngineMove);
+                move = search->think(checkboard);
+            }
+            auto from = make_shared<Point>(move.getFrom());
+            auto to = make_shared<Point>(move.getTo());
+            auto figure = checkboard->at(from);
+            auto possibleFigure = checkboard->at(to);
+            if (!checkboard->prepareMove(from, to, move.getPromotion()))
+                throw runtime_error("Engine came up with impossible move " + move.asString());
+
+            ostringstream info;
+            info << "Engine plays " << move.asString();
+            if (instant)
+                info << " (" << instant << ")";
+            else
+                info << " (depth " << search->getDepth() << ", score " << search->getScore()
+                     << ", nodes " << search->getNodes() << ")";
+            view->renderText(info.str());
+            if (possibleFigure)
+                view->renderKillText(possibleFigure->asChar(), figure->asChar());
+
+            if (!punchClock(side))
+                goto finish_game;
+        } break;
+        case 3:
             try {
+                // otherwise a save still in flight leaves the older savefile to load
+                backgroundSaver->flush();
+                renderSaveReports();
                 auto file = saver->loadCheckboard();
                 checkboard = file;
                 view->renderText("Game loaded");
+                autosave(true);
             } catch (std::exception& e) {
                 view->renderText("Couldn't restore the game :(");
                 view->renderText(e.what());
             }
 
             continue;
-        case 3:
+        case 4:
             view->renderText("Game restarted");
             checkboard->initialize();
-            return run();
-        case 4:
+            return play();
+        case 5:
             goto finish_game;
         default:
             throw runtime_error("how could you even get here????");
         }
 
         checkboard->setTurn(!checkboard->getWhitesTurn());
+        autosave(false);
     }
 finish_game:
-    return !checkboard->getWhitesTurn();
+    return checkboard->getWhitesTurn() ? BlacksWon : WhitesWon;
+}
+
+bool Game::punchClock(FigurePlayer side)
+{
+    if (!gameClock)
+        return true;
+    gameClock->stop();
+    if (!gameClock->isFlagged(side))
+        return true;
+
+    view->renderText(side == Whites ? "Whites ran out of time" : "Blacks ran out of time");
+    return false;
+}
+
+void Game::autosave(bool restart)
+{
+    if (!journal)
+        return;
+
+    // losing the autosave is no reason to stop the game
+    try {
+        if (restart || !journal->isStarted())
+            journal->start(*checkboard);
+        else
+            journal->append(*checkboard);
+    } catch (std::exception& e) {
+        view->renderText("Couldn't autosave the game :(");
+        view->renderText(e.what());
+    }
+}
+
+void Game::recordGame(GameResult result)
+{
+    if (pgnFile.empty())
+        return;
+
+    static const char* const results[] = {"1-0", "0-1", "1/2-1/2"};
+    char date[16];
+    const auto now = chrono::system_clock::to_time_t(chrono::system_clock::now());
+    strftime(date, sizeof(date), "%Y.%m.%d", localtime(&now));
+
+    try {
+        PgnWriter writer;
+        writer.write(*checkboard, {{"Event", "Casual game"}, {"Date", date}}, results[result]);
+        ofstream file(pgnFile, ios::app);
+        writer.flush(file);
+        if (!file)
+            throw runtime_error("Couldn't write to " + pgnFile);
+    } catch (std::exception& e) {
+        view->renderText("Couldn't record the game :(");
+        view->renderText(e.what());
+    }
+}
+
+void Game::renderSaveReports()
+{
+    if (!backgroundSaver)
+        return;
+    for (const auto& report : backgroundSaver->takeReports())
+        view->renderText(report);
 }
 
 Game::~Game()
@@ -114,25 +287,16 @@ Game::~Game()
 
 PFigure Game::selectFigure(const set<PFigure>& allowed)
 {
+    // look-alike figures are told apart by their ids
+    bitset<Chessboard::MaxFigures> allowedIds;
+    for (const auto& i : allowed)
+        allowedIds.set(i->getId());
+
+    auto good = [&](const PFigure& f) -> bool { return f && allowedIds.test(f->getId()); };
+
     auto from = view->getPoint("Enter point from where to move: (0-7 0-7)");
     auto figure = checkboard->at(from);
-
-    auto ally = [&](const PFigure& f) -> bool {
-        bool t = checkboard->getWhitesTurn();
-        return !(
-            (f->getPlayer() == FigurePlayer::Whites && !t)
-            || (f->getPlayer() == FigurePlayer::Blacks && t));
-    };
-
-    auto good = [&](const PFigure& f) -> bool {
-        for (const auto& i : allowed)
-            if (*i == *f)
-                if (*i->getPoint() == *f->getPoint())
-                    return true;
-        return false;
-    };
-
-    while (!figure && !ally(figure) && !good(figure)) {
+    while (!good(figure)) {
         view->renderText("No suitable ally figures found at specified point, try again");
         from = view->getPoint("from where to move: (0-7 0-7)");
         figure = checkboard->at(from);
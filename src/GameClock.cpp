@@ -0,0 +1,74 @@
+#include <Figure.h>
+#include <GameClock.h>
+
+using namespace std;
+using namespace std::chrono;
+
+GameClock::GameClock(milliseconds b, milliseconds inc, unsigned int movesToGo)
+    : base(b)
+    , increment(inc)
+    , movesPerPeriod(movesToGo)
+    , remaining{b, b}
+    , movesMade{0, 0}
+    , running(Whites)
+    , ticking(false)
+{
+}
+
+void GameClock::reset()
+{
+    remaining[Whites] = remaining[Blacks] = base;
+    movesMade[Whites] = movesMade[Blacks] = 0;
+    ticking = false;
+}
+
+void GameClock::start(FigurePlayer side)
+{
+    if (ticking && running == side)
+        return;
+    if (ticking)
+        stop();
+    running = side;
+    turnStarted = clock::now();
+    ticking = true;
+}
+
+void GameClock::stop()
+{
+    if (!ticking)
+        return;
+    ticking = false;
+
+    remaining[running] -= duration_cast<milliseconds>(clock::now() - turnStarted);
+    if (isFlagged(running))
+        return;
+
+    remaining[running] += increment;
+    ++movesMade[running];
+    if (movesPerPeriod && movesMade[running] % movesPerPeriod == 0)
+        remaining[running] += base;
+}
+
+milliseconds GameClock::getRemaining(FigurePlayer side) const
+{
+    if (ticking && side == running)
+        return remaining[side] - duration_cast<milliseconds>(clock::now() - turnStarted);
+    return remaining[side];
+}
+
+milliseconds GameClock::getIncrement() const
+{
+    return increment;
+}
+
+unsigned int GameClock::getMovesToGo(FigurePlayer side) const
+{
+    if (!movesPerPeriod)
+        return 0;
+    return movesPerPeriod - movesMade[side] % movesPerPeriod;
+}
+
+bool GameClock::isFlagged(FigurePlayer side) const
+{
+    return getRemaining(side) <= milliseconds(0);
+}
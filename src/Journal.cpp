@@ -0,0 +1,149 @@
+#include <BoardSnapshot.h>
+#include <Bytes.h>
+#include <Chessboard.h>
+#include <Journal.h>
+#include <MappedFile.h>
+#include <Move.h>
+#include <Point.h>
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+// header: magic, version (2), reserved (2)
+// then records, each starting with a tag byte:
+//   checkpoint tag, packed BoardSnapshot
+//   move tag, packed Move
+const char journalMagic[4] = {'C', 'H', 'S', 'J'};
+const uint16_t journalVersion = 1;
+const size_t journalHeaderSize = 8;
+const uint8_t checkpointTag = 'C';
+const uint8_t moveTag = 'M';
+
+[[noreturn]] void badJournal()
+{
+    throw runtime_error("Got bad formatted journal");
+}
+
+} // namespace
+
+Journal::Journal(string f, unsigned int interval)
+    : fileName(std::move(f))
+    , checkpointInterval(interval ? interval : 1)
+{
+}
+
+void Journal::write(const uint8_t* data, size_t size)
+{
+    if (!file.is_open())
+        throw runtime_error("Journal is not started");
+    file.write((const char*)data, (streamsize)size);
+    file.flush();
+    if (!file)
+        throw runtime_error("Couldn't write to journal");
+}
+
+void Journal::start(const Chessboard& board)
+{
+    file.close();
+    file.clear();
+    file.open(fileName, ios::binary | ios::trunc);
+    if (!file.is_open())
+        throw runtime_error("Couldn't write to journal");
+
+    uint8_t header[journalHeaderSize] = {};
+    memcpy(header, journalMagic, sizeof(journalMagic));
+    Bytes::storeLittle(header + 4, journalVersion);
+    write(header, sizeof(header));
+    checkpoint(board);
+}
+
+void Journal::append(const Chessboard& board)
+{
+    const auto& moves = board.getMoves();
+    if (moves.empty())
+        throw invalid_argument("Board has no moves to record");
+
+    uint8_t record[1 + Move::PackedSize] = {moveTag};
+    moves.back().pack(record + 1);
+    write(record, sizeof(record));
+
+    if (++movesSinceCheckpoint >= checkpointInterval)
+        checkpoint(board);
+}
+
+void Journal::checkpoint(const Chessboard& board)
+{
+    uint8_t record[1 + BoardSnapshot::PackedSize] = {checkpointTag};
+    board.snapshot().pack(record + 1);
+    write(record, sizeof(record));
+    movesSinceCheckpoint = 0;
+}
+
+bool Journal::isStarted() const
+{
+    return file.is_open();
+}
+
+PChessboard Journal::load() const
+{
+    MappedFile mapped(fileName);
+    return replay(mapped.getData(), mapped.getSize());
+}
+
+bool Journal::isJournal(const uint8_t* data, size_t size)
+{
+    return size >= sizeof(journalMagic) && memcmp(data, journalMagic, sizeof(journalMagic)) == 0;
+}
+
+PChessboard Journal::replay(const uint8_t* data, size_t size, bool wholeGame)
+{
+    if (size < journalHeaderSize || !isJournal(data, size)
+        || Bytes::loadLittle<uint16_t>(data + 4) != journalVersion)
+        badJournal();
+
+    // find the last complete checkpoint, moves before it are not needed
+    // unless the whole game is asked for
+    const uint8_t* checkpoint = nullptr;
+    const uint8_t* end = data + size;
+    const uint8_t* record = data + journalHeaderSize;
+    while (record < end) {
+        size_t recordSize;
+        if (*record == checkpointTag)
+            recordSize = 1 + BoardSnapshot::PackedSize;
+        else if (*record == moveTag)
+            recordSize = 1 + Move::PackedSize;
+        else
+            badJournal();
+        if ((size_t)(end - record) < recordSize) // crashed in the middle of writing
+            break;
+        if (*record == checkpointTag && (!checkpoint || !wholeGame))
+            checkpoint = record;
+        record += recordSize;
+    }
+    if (!checkpoint)
+        badJournal();
+
+    auto board = make_shared<Chessboard>(BoardSnapshot::unpack(checkpoint + 1));
+    record = checkpoint + 1 + BoardSnapshot::PackedSize;
+    while (record < end) {
+        // later checkpoints repeat the position the moves have led to
+        const auto left = (size_t)(end - record);
+        if (wholeGame && *record == checkpointTag && left >= 1 + BoardSnapshot::PackedSize) {
+            record += 1 + BoardSnapshot::PackedSize;
+            continue;
+        }
+        if (left < 1 + Move::PackedSize || *record != moveTag)
+            break;
+        const auto move = Move::unpack(record + 1);
+        if (!board->prepareMove(make_shared<Point>(move.getFrom()), make_shared<Point>(move.getTo()),
+                                move.getPromotion()))
+            throw runtime_error("Journal has impossible move " + move.asString());
+        board->setTurn(!board->getWhitesTurn());
+        record += 1 + Move::PackedSize;
+    }
+    return board;
+}
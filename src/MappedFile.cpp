@@ -0,0 +1,109 @@
+#include <MappedFile.h>
+
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#if defined(_WIN32)
+
+MappedFile::MappedFile(const string& fileName)
+{
+    file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                       FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        file = nullptr;
+        throw runtime_error("Couldn't open " + fileName);
+    }
+
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length)) {
+        close();
+        throw runtime_error("Couldn't read size of " + fileName);
+    }
+    size = (size_t)length.QuadPart;
+    if (!size) // empty files cannot be mapped
+        return;
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        close();
+        throw runtime_error("Couldn't map " + fileName);
+    }
+    data = static_cast<const uint8_t*>(view);
+}
+
+void MappedFile::close()
+{
+    if (data)
+        UnmapViewOfFile(data);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file)
+        CloseHandle(file);
+    data = nullptr;
+    mapping = file = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile(const string& fileName)
+{
+    file = open(fileName.c_str(), O_RDONLY);
+    if (file < 0)
+        throw runtime_error("Couldn't open " + fileName);
+
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        close();
+        throw runtime_error("Couldn't read size of " + fileName);
+    }
+    size = (size_t)status.st_size;
+    if (!size) // empty files cannot be mapped
+        return;
+
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (view == MAP_FAILED) {
+        close();
+        throw runtime_error("Couldn't map " + fileName);
+    }
+    data = static_cast<const uint8_t*>(view);
+}
+
+void MappedFile::close()
+{
+    if (data)
+        munmap(const_cast<uint8_t*>(data), size);
+    if (file >= 0)
+        ::close(file);
+    data = nullptr;
+    file = -1;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+const uint8_t* MappedFile::getData() const
+{
+    return data;
+}
+
+size_t MappedFile::getSize() const
+{
+    return size;
+}
@@ -0,0 +1,62 @@
+#include <Figure.h>
+#include <Move.h>
+#include <Point.h>
+
+#include <stdexcept>
+
+using namespace std;
+
+Move::Move(const Point& a, const Point& b, FigureType p)
+    : from((uint8_t)(a.getY() * 8 + a.getX()))
+    , to((uint8_t)(b.getY() * 8 + b.getX()))
+    , promotion((uint8_t)p)
+{
+}
+
+Point Move::getFrom() const
+{
+    return Point(from % 8, from / 8);
+}
+
+Point Move::getTo() const
+{
+    return Point(to % 8, to / 8);
+}
+
+FigureType Move::getPromotion() const
+{
+    return static_cast<FigureType>(promotion);
+}
+
+string Move::asString() const
+{
+    return getFrom().asString() + " -> " + getTo().asString();
+}
+
+void Move::pack(uint8_t* out) const
+{
+    out[0] = from;
+    out[1] = to;
+    out[2] = promotion;
+}
+
+Move Move::unpack(const uint8_t* data)
+{
+    if (data[0] >= 64 || data[1] >= 64 || data[2] == Pawn || data[2] >= King)
+        throw invalid_argument("Got bad formatted move");
+    Move move;
+    move.from = data[0];
+    move.to = data[1];
+    move.promotion = data[2];
+    return move;
+}
+
+bool Move::operator==(const Move& move) const
+{
+    return from == move.from && to == move.to && promotion == move.promotion;
+}
+
+bool Move::operator!=(const Move& move) const
+{
+    return !(*this == move);
+}
@@ -0,0 +1,38 @@
+#include <Attacks.h>
+#include <Move.h>
+#include <MoveCache.h>
+#include <Point.h>
+
+using namespace std;
+
+MoveCache::MoveCache()
+    : targets{}
+{
+}
+
+void MoveCache::fill(multimap<PFigure, PPoint> m)
+{
+    moves = std::move(m);
+    targets.fill(0);
+    for (const auto& i : moves)
+        targets[Attacks::square(i.first->getX(), i.first->getY())]
+            |= Attacks::bit(i.second->getX(), i.second->getY());
+}
+
+const multimap<PFigure, PPoint>& MoveCache::getMoves() const
+{
+    return moves;
+}
+
+Bitboard MoveCache::getTargets(const Point& from) const
+{
+    if (!from.inBounds())
+        return 0;
+    return targets[Attacks::square(from.getX(), from.getY())];
+}
+
+bool MoveCache::contains(const Move& move) const
+{
+    const auto to = move.getTo();
+    return getTargets(move.getFrom()) & Attacks::bit(to.getX(), to.getY());
+}
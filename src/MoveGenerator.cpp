@@ -0,0 +1,134 @@
+#include <Attacks.h>
+#include <Chessboard.h>
+#include <Figure.h>
+#include <Move.h>
+#include <MoveGenerator.h>
+#include <Point.h>
+
+using namespace std;
+
+namespace {
+
+// queen comes first, it is the one that matters almost always
+const FigureType promotions[] = {Queen, Rook, Bishop, Knight};
+
+} // namespace
+
+MoveGenerator::MoveGenerator(const Chessboard& b, FigurePlayer s)
+    : board(b)
+    , side(s)
+    , stage(Captures)
+    , id(~0u) // first figure is picked by the first call of next()
+    , pending(0)
+    , targets{}
+    , built{}
+    , enemies(b.occupancy(s == Whites ? Blacks : Whites))
+    , taken(b.occupancy(Whites) | b.occupancy(Blacks))
+    , promotionsLeft(0)
+{
+}
+
+bool MoveGenerator::advance()
+{
+    while (stage != Done) {
+        for (++id; id < Chessboard::MaxFigures; ++id) {
+            const auto square = board.getSquare(id);
+            if (square < 0)
+                continue;
+            const auto& figure = board.getFigure(id);
+            if (figure->getPlayer() != side)
+                continue;
+
+            if (!built[id]) {
+                targets[id] = board.buildTargets(figure);
+                built[id] = true;
+            }
+
+            // en passant square is empty, yet it is a capture
+            Bitboard captures = enemies;
+            if (figure->isPawn() && board.getEnPassant() >= 0)
+                captures |= Bitboard(1) << board.getEnPassant();
+            // quiet moves only go to empty squares, which also skips the rook's
+            // castling onto own king: the king's move already covers it
+            pending = targets[id] & (stage == Captures ? captures : ~(taken | captures));
+            if (pending)
+                return true;
+        }
+        stage = static_cast<Stage>(stage + 1);
+        id = ~0u;
+    }
+    return false;
+}
+
+bool MoveGenerator::next(Move& move)
+{
+    if (promotionsLeft) {
+        const auto from = promotionMove.getFrom(), to = promotionMove.getTo();
+        move = Move(from, to, promotions[4 - promotionsLeft--]);
+        return true;
+    }
+
+    while (pending || advance()) {
+        const auto to = Attacks::popLowest(pending);
+        const auto& figure = board.getFigure(id);
+        if (!board.keepsKingSafe(figure, to))
+            continue;
+
+        move = Move(*figure->getPoint(), Point(to % 8, to / 8));
+        if (board.isPromotion(move)) {
+            promotionMove = move;
+            promotionsLeft = 3;
+        }
+        return true;
+    }
+    return false;
+}
+
+MoveGenerator::Stage MoveGenerator::getStage() const
+{
+    return stage;
+}
+
+MoveGenerator::iterator MoveGenerator::begin()
+{
+    return iterator(this);
+}
+
+MoveGenerator::iterator MoveGenerator::end()
+{
+    return iterator();
+}
+
+MoveGenerator::iterator::iterator(MoveGenerator* g)
+    : generator(g)
+{
+    if (generator && !generator->next(current))
+        generator = nullptr;
+}
+
+MoveGenerator::iterator::reference MoveGenerator::iterator::operator*() const
+{
+    return current;
+}
+
+MoveGenerator::iterator::pointer MoveGenerator::iterator::operator->() const
+{
+    return &current;
+}
+
+MoveGenerator::iterator& MoveGenerator::iterator::operator++()
+{
+    if (generator && !generator->next(current))
+        generator = nullptr;
+    return *this;
+}
+
+bool MoveGenerator::iterator::operator==(const iterator& other) const
+{
+    return generator == other.generator;
+}
+
+bool MoveGenerator::iterator::operator!=(const iterator& other) const
+{
+    return !(*this == other);
+}
@@ -3,6 +3,7 @@
 #include <Point.h>
 
 #include <algorithm>
+#include <cstdlib>
 #include <list>
 #include <map>
 #include <set>
@@ -13,233 +14,125 @@ using namespace std;
 PathSystem::PathSystem(const PFigures& b)
     : board(b)
 {
+    indexSquares();
 }
 
 PathSystem::PathSystem(){};
 
 PPoints PathSystem::buildPath(const PFigure& figure) const
+{
+    return toPoints(buildSquares(figure));
+}
+
+Bitboard PathSystem::buildSquares(const PFigure& figure) const
 {
     if (!figure)
         throw invalid_argument("Cannot build path for nullptr");
 
-    PPoints rawMoves;
-
-    // build possible path for different figure types
-    if (figure->isPawn())
-        rawMoves.splice(rawMoves.end(), buildPawnPath(figure));
-
-    if (figure->isRook() || figure->isQueen())
-        rawMoves.splice(rawMoves.end(), buildRookPath(figure));
-
-    if (figure->isKnight())
-        rawMoves.splice(rawMoves.end(), buildKnightPath(figure));
-
-    if (figure->isBishop() || figure->isQueen())
-        rawMoves.splice(rawMoves.end(), buildBishopPath(figure));
-
-    if (figure->isKing()) {
-        rawMoves.splice(rawMoves.end(), buildKingPath(figure));
+    // single figure requests are the only place where we dispatch at runtime
+    const auto side = figure->getPlayer();
+    const auto own = occupancy(side);
+    const auto enemy = occupancy(side == Whites ? Blacks : Whites);
+
+#define BUILD_PATH_FOR(SIDE)                                                                       \
+    switch (figure->getType()) {                                                                   \
+    case Pawn:                                                                                     \
+        return buildPathFor<SIDE, Pawn>(figure, own, enemy);                                       \
+    case Rook:                                                                                     \
+        return buildPathFor<SIDE, Rook>(figure, own, enemy);                                       \
+    case Knight:                                                                                   \
+        return buildPathFor<SIDE, Knight>(figure, own, enemy);                                     \
+    case Bishop:                                                                                   \
+        return buildPathFor<SIDE, Bishop>(figure, own, enemy);                                     \
+    case Queen:                                                                                    \
+        return buildPathFor<SIDE, Queen>(figure, own, enemy);                                      \
+    case King:                                                                                     \
+        return buildPathFor<SIDE, King>(figure, own, enemy);                                       \
     }
 
-    /// there may be so many of them, not really want to break any iterators
-    PPoints possibleMoves;
-    for (const auto& i : rawMoves)
-        if (i)
-            possibleMoves.push_back(i);
-
-    return possibleMoves;
-}
-
-PPoint PathSystem::addOrDie(const PPoint& p, FigurePlayer side, bool pawnMode) const
-{
-    if (!p)
-        return nullptr;
-
-    auto fig = at(p);
-    bool differentSides = fig && fig->getPlayer() != side;
-    // pawns can capture on diagonals but not vertically
-    bool allowNext
-        = p->inBounds() && (pawnMode ? (fig && differentSides) : (!fig || differentSides));
+    if (side == Whites) {
+        BUILD_PATH_FOR(Whites);
+    } else {
+        BUILD_PATH_FOR(Blacks);
+    }
+#undef BUILD_PATH_FOR
 
-    return allowNext ? p : nullptr;
+    return 0;
 }
 
-PPoints PathSystem::buildPawnPath(const PFigure& figure) const
+template <FigurePlayer side, FigureType type>
+Bitboard PathSystem::buildPathFor(const PFigure& figure, Bitboard own, Bitboard enemy) const
 {
-    PPoints path;
-    int x = figure->getPoint()->getX(), y = figure->getPoint()->getY();
-    auto side = figure->getPlayer();
-
-    auto pawnY = side == FigurePlayer::Whites ? 1 : -1;
-
-    auto p = addOrDie(make_shared<Point>(x, y + pawnY), side,
-                      false); // cannot attack forward
-    if (p && !at(p)) {
-        path.push_back(p);
-        if (figure->getMovesCount() == 0)
-            path.push_back(addOrDie(make_shared<Point>(x, y + 2 * pawnY), side, false));
-    }
+    const auto square = Attacks::square(figure->getX(), figure->getY());
 
-    path.push_back(addOrDie(make_shared<Point>(x + 1, y + pawnY), side, true));
-    path.push_back(addOrDie(make_shared<Point>(x - 1, y + pawnY), side, true));
-
-    return path;
+    // build possible path for different figure types
+    if constexpr (type == Pawn)
+        return buildPawnPath<side>(figure, own, enemy);
+    else if constexpr (type == Knight)
+        return Attacks::knight[square] & ~own;
+    else if constexpr (type == Bishop)
+        return Attacks::bishop(square, own | enemy) & ~own;
+    else if constexpr (type == Rook)
+        return buildRookPath<side>(figure, own, enemy);
+    else if constexpr (type == Queen)
+        return (Attacks::rook(square, own | enemy) | Attacks::bishop(square, own | enemy)) & ~own;
+    else
+        return buildKingPath<side>(figure, own);
 }
 
-PPoints PathSystem::buildKnightPath(const PFigure& figure) const
+template <FigurePlayer side>
+Bitboard PathSystem::buildPawnPath(const PFigure& figure, Bitboard own, Bitboard enemy) const
 {
-    PPoints path;
-    int x = figure->getPoint()->getX(), y = figure->getPoint()->getY();
-    auto side = figure->getPlayer();
-
-    /// to the right
-    path.push_back(addOrDie(make_shared<Point>(x + 2, y + 1), side, false));
-    path.push_back(addOrDie(make_shared<Point>(x + 2, y - 1), side, false));
+    int x = figure->getX(), y = figure->getY();
+    constexpr auto pawnY = SideTraits<side>::pawnStep;
 
-    /// to the left
-    path.push_back(addOrDie(make_shared<Point>(x - 2, y + 1), side, false));
-    path.push_back(addOrDie(make_shared<Point>(x - 2, y - 1), side, false));
+    // cannot attack forward
+    Bitboard path = Attacks::bit(x, y + pawnY) & ~(own | enemy);
+    if (path && figure->getMovesCount() == 0)
+        path |= Attacks::bit(x, y + 2 * pawnY) & ~(own | enemy);
 
-    /// to the top
-    path.push_back(addOrDie(make_shared<Point>(x + 1, y + 2), side, false));
-    path.push_back(addOrDie(make_shared<Point>(x - 1, y + 2), side, false));
+    // en passant square is only left behind by the enemy's pawns
+    Bitboard targets = enemy;
+    if (enPassant >= 0 && enPassant / 8 == (int)SideTraits<side>::promotionRank - 2 * pawnY)
+        targets |= Bitboard(1) << enPassant;
 
-    /// to the bottom
-    path.push_back(addOrDie(make_shared<Point>(x + 1, y - 2), side, false));
-    path.push_back(addOrDie(make_shared<Point>(x - 1, y - 2), side, false));
-
-    return path;
+    // pawns can capture on diagonals but not vertically
+    return path | (Attacks::pawn[side][Attacks::square(x, y)] & targets);
 }
 
-PPoints PathSystem::buildRookPath(const PFigure& figure) const
+template <FigurePlayer side>
+Bitboard PathSystem::buildRookPath(const PFigure& figure, Bitboard own, Bitboard enemy) const
 {
-    PPoints path;
-    int x = figure->getPoint()->getX(), y = figure->getPoint()->getY();
-    auto side = figure->getPlayer();
-    /// to the right
-    for (int i = x + 1; i < 8; ++i) {
-        auto p = addOrDie(make_shared<Point>(i, y), side, false);
-        if (!p)
-            break;
-        path.push_back(p);
-        auto f = at(p);
-        if (f)
-            break; // we cannot move through figures
-    }
-
-    /// to the left
-    for (int i = x - 1; i >= 0; --i) {
-        auto p = addOrDie(make_shared<Point>(i, y), side, false);
-        if (!p)
-            break;
-        path.push_back(p);
-        auto f = at(p);
-        if (f)
-            break; // we cannot move through figures
-    }
-
-    /// to the top
-    for (int i = y + 1; i < 8; ++i) {
-        auto p = addOrDie(make_shared<Point>(x, i), side, false);
-        if (!p)
-            break;
-        path.push_back(p);
-        auto f = at(p);
-        if (f)
-            break; // we cannot move through figures
-    }
-
-    /// to the bottom
-    for (int i = y - 1; i >= 0; --i) {
-        auto p = addOrDie(make_shared<Point>(x, i), side, false);
-        if (!p)
-            break;
-        path.push_back(p);
-        auto f = at(p);
-        if (f)
-            break; // we cannot move through figures
-    }
+    const auto square = Attacks::square(figure->getX(), figure->getY());
+    // we cannot move through figures
+    auto path = Attacks::rook(square, own | enemy) & ~own;
 
     /// check castling
-
-    auto king = side == FigurePlayer::Whites ? at(make_shared<Point>(4, 0))
-                                             : at(make_shared<Point>(4, 7));
+    typedef SideTraits<side> Traits;
+    auto king = at(make_shared<Point>(Traits::kingFile, Traits::homeRank));
 
     if (checkCastling(figure, king))
-        path.push_back(make_shared<Point>(king->getX(), y));
-
-    // return
-    return path;
-}
-
-PPoints PathSystem::buildBishopPath(const PFigure& figure) const
-{
-    PPoints path;
-    int x = figure->getPoint()->getX(), y = figure->getPoint()->getY();
-    auto side = figure->getPlayer();
-
-    bool good = true;
-    /// to the right-top
-    for (int i = x + 1, j = y + 1; j < 8 && i < 8 && good; ++i, ++j) {
-        auto p = addOrDie(make_shared<Point>(i, j), side, false);
-        path.push_back(p);
-        good = !!p ? !at(p) : false; // we cannot move through figures
-    }
-
-    good = true;
-    /// to the left-top
-    for (int i = x - 1, j = y + 1; j < 8 && i >= 0 && good; --i, ++j) {
-        auto p = addOrDie(make_shared<Point>(i, j), side, false);
-        path.push_back(p);
-        good = !!p ? !at(p) : false; // we cannot move through figures
-    }
-
-    good = true;
-    /// to the right-bottom
-    for (int i = x + 1, j = y - 1; j >= 0 && i < 8 && good; ++i, --j) {
-        auto p = addOrDie(make_shared<Point>(i, j), side, false);
-        path.push_back(p);
-        good = !!p ? !at(p) : false; // we cannot move through figures
-    }
-
-    good = true;
-    /// to the left-bottom
-    for (int i = x - 1, j = y - 1; j >= 0 && i >= 0 && good; --i, --j) {
-        auto p = addOrDie(make_shared<Point>(i, j), side, false);
-        path.push_back(p);
-        good = !!p ? !at(p) : false; // we cannot move through figures
-    }
+        path |= Attacks::bit(king->getX(), figure->getY());
 
     return path;
 }
 
-PPoints PathSystem::buildKingPath(const PFigure& figure) const
+template <FigurePlayer side>
+Bitboard PathSystem::buildKingPath(const PFigure& figure, Bitboard own) const
 {
-    PPoints path;
-    int x = figure->getPoint()->getX(), y = figure->getPoint()->getY();
-    auto side = figure->getPlayer();
-
-    path.push_back(addOrDie(make_shared<Point>(x + 1, y), side, false));
-    path.push_back(addOrDie(make_shared<Point>(x - 1, y), side, false));
+    int x = figure->getX(), y = figure->getY();
 
-    path.push_back(addOrDie(make_shared<Point>(x + 1, y + 1), side, false));
-    path.push_back(addOrDie(make_shared<Point>(x - 1, y + 1), side, false));
-    path.push_back(addOrDie(make_shared<Point>(x - 1, y - 1), side, false));
-    path.push_back(addOrDie(make_shared<Point>(x + 1, y - 1), side, false));
+    auto path = Attacks::king[Attacks::square(x, y)] & ~own;
 
-    path.push_back(addOrDie(make_shared<Point>(x, y + 1), side, false));
-    path.push_back(addOrDie(make_shared<Point>(x, y - 1), side, false));
-
-    auto rook1 = side == FigurePlayer::Whites ? at(make_shared<Point>(0, 0))
-                                              : at(make_shared<Point>(0, 7));
-    auto rook2 = side == FigurePlayer::Whites ? at(make_shared<Point>(7, 0))
-                                              : at(make_shared<Point>(7, 7));
+    typedef SideTraits<side> Traits;
+    auto rook1 = at(make_shared<Point>(Traits::queenRookFile, Traits::homeRank));
+    auto rook2 = at(make_shared<Point>(Traits::kingRookFile, Traits::homeRank));
 
     if (rook1 && checkCastling(figure, rook1))
-        path.push_back(make_shared<Point>(x - 2, y));
+        path |= Attacks::bit(x - 2, y);
 
     if (rook2 && checkCastling(figure, rook2))
-        path.push_back(make_shared<Point>(x + 2, y));
+        path |= Attacks::bit(x + 2, y);
 
     return path;
 }
@@ -277,19 +170,57 @@ bool PathSystem::checkCastling(const PFigure& one, const PFigure& two) const
         /// tmp is an obstacle for castling
         break;
     }
+    if (!castlingPathClear)
+        return false;
 
-    return castlingPathClear;
+    /// king may neither castle out of check nor pass an attacked square
+    const auto enemySide = king->getPlayer() == Whites ? Blacks : Whites;
+    const int kingSquare = Attacks::square(kingX, king->getY());
+    const int passed = kingSquare + (rookX > kingX ? 1 : -1);
+    const auto pieces = placement();
+    return !isAttacked(kingSquare, enemySide, pieces) && !isAttacked(passed, enemySide, pieces);
 }
 
 PFigure PathSystem::at(const PPoint& point) const
 {
     if (!point || !point->inBounds())
         return nullptr;
+    return squares[Attacks::square(point->getX(), point->getY())];
+}
 
+void PathSystem::indexSquares()
+{
+    squares.fill(nullptr);
     for (const auto& item : board)
-        if (*(item->getPoint()) == *point)
-            return item;
-    return nullptr;
+        squares[Attacks::square(item->getX(), item->getY())] = item;
+}
+
+Bitboard PathSystem::occupancy(FigurePlayer side) const
+{
+    Bitboard squares = 0;
+    for (const auto& item : board)
+        if (item->isAlive() && item->getPlayer() == side)
+            squares |= Attacks::bit(item->getX(), item->getY());
+    return squares;
+}
+
+PathSystem::Placement PathSystem::placement() const
+{
+    Placement pieces{};
+    for (const auto& item : board)
+        if (item->isAlive())
+            pieces[item->getPlayer()][item->getType()] |= Attacks::bit(item->getX(), item->getY());
+    return pieces;
+}
+
+PPoints PathSystem::toPoints(Bitboard squares)
+{
+    PPoints points;
+    while (squares) {
+        auto square = Attacks::popLowest(squares);
+        points.push_back(make_shared<Point>(square % 8, square / 8));
+    }
+    return points;
 }
 
 const PFigures& PathSystem::getBoard() const
@@ -300,6 +231,12 @@ const PFigures& PathSystem::getBoard() const
 void PathSystem::setBoard(const PFigures& list)
 {
     board = list;
+    indexSquares();
+}
+
+void PathSystem::setEnPassant(int square)
+{
+    enPassant = square;
 }
 
 PPoints PathSystem::checkForAnyMovement(const PFigure& from) const
@@ -311,56 +248,149 @@ PPoints PathSystem::checkForAnyMovement(const PFigure& from) const
 
 bool PathSystem::checkForMovement(const PFigure& figure, const PPoint& to) const
 {
-    if (!figure || !to)
+    return isLegal(figure, to);
+}
+
+bool PathSystem::isLegal(const PFigure& figure, const PPoint& to) const
+{
+    if (!figure || !to || !to->inBounds())
         return false;
 
-    auto possibleMoves = checkForAnyMovement(figure);
+    if (!(buildSquares(figure) & Attacks::bit(to->getX(), to->getY())))
+        return false;
+    return keepsKingSafe(figure, Attacks::square(to->getX(), to->getY()));
+}
 
-    // after we got path we perform actual movement if final point is on path
-    bool finalOnPath = false;
-    for (const auto& i : possibleMoves)
-        if (*to == *i) {
-            finalOnPath = true;
-            break;
-        }
-    if (!finalOnPath)
+bool PathSystem::keepsKingSafe(const PFigure& figure, int to) const
+{
+    const auto& possibleFigure = squares[to];
+    if (possibleFigure && possibleFigure->isKing()
+        && possibleFigure->getPlayer() != figure->getPlayer()) // king cannot be killed
         return false;
 
-    auto possibleFigure = at(to);
-    if (possibleFigure && possibleFigure->isKing()) // king cannot be killed
+    return !kingAttackedAfter(figure, to);
+}
+
+bool PathSystem::kingAttackedAfter(const PFigure& figure, int to) const
+{
+    auto pieces = placement();
+    const auto side = figure->getPlayer();
+    const auto enemySide = side == Whites ? Blacks : Whites;
+    const int from = Attacks::square(figure->getX(), figure->getY());
+    const Bitboard fromBit = Bitboard(1) << from, toBit = Bitboard(1) << to;
+
+    if (figure->isRook() && (pieces[side][King] & toBit)) {
+        // castling by moving rook onto the king: king jumps two squares towards the rook
+        // squares the king starts from and passes were checked by checkCastling
+        const int direction = from < to ? -1 : 1;
+        const int kingTo = to + 2 * direction;
+        pieces[side][King] ^= toBit | Bitboard(1) << kingTo;
+        pieces[side][Rook] ^= fromBit | Bitboard(1) << (kingTo - direction);
+    } else if (figure->isKing() && abs(to - from) == 2) {
+        // castling by king move, rook comes from the corner
+        const int direction = to > from ? 1 : -1;
+        const int rookFrom = to - to % 8 + (direction > 0 ? 7 : 0);
+        pieces[side][King] ^= fromBit | toBit;
+        pieces[side][Rook] ^= Bitboard(1) << rookFrom | Bitboard(1) << (to - direction);
+    } else if (figure->isPawn() && to == enPassant && to % 8 != from % 8) {
+        // captured pawn stands behind the square it skipped
+        const int captured = to + (from < to ? -8 : 8);
+        pieces[enemySide][Pawn] &= ~(Bitboard(1) << captured);
+        pieces[side][Pawn] ^= fromBit | toBit;
+    } else {
+        for (auto& squares : pieces[enemySide])
+            squares &= ~toBit;
+        pieces[side][figure->getType()] ^= fromBit | toBit;
+    }
+
+    if (!pieces[side][King]) // nothing to protect in testing mode
         return false;
+    return isAttacked(Attacks::lowest(pieces[side][King]), enemySide, pieces);
+}
 
-    auto moves = getListOfAvailableMoves(figure->getPlayer());
+Bitboard PathSystem::attackersTo(int square, const Placement& pieces)
+{
+    Bitboard taken = 0;
+    for (const auto& side : pieces)
+        for (auto squares : side)
+            taken |= squares;
+
+    const auto rooks = Attacks::rook(square, taken), bishops = Attacks::bishop(square, taken);
+    Bitboard attackers = 0;
+    for (auto by : {Whites, Blacks}) {
+        const auto& enemy = pieces[by];
+        attackers |= (Attacks::knight[square] & enemy[Knight]) | (Attacks::king[square] & enemy[King])
+            | (Attacks::pawn[by == Whites ? Blacks : Whites][square] & enemy[Pawn])
+            | (rooks & (enemy[Rook] | enemy[Queen])) | (bishops & (enemy[Bishop] | enemy[Queen]));
+    }
+    return attackers;
+}
 
-    for (const auto& i : moves)
-        if (*i.first == *figure)
-            if (*i.second == *to)
-                return true;
+bool PathSystem::isAttacked(int square, FigurePlayer by, const Placement& pieces)
+{
+    Bitboard taken = 0;
+    for (const auto& side : pieces)
+        for (auto squares : side)
+            taken |= squares;
+
+    const auto& enemy = pieces[by];
+    const auto target = by == Whites ? Blacks : Whites;
+    // look from the square backwards: it is attacked by whatever it would attack itself
+    return (Attacks::knight[square] & enemy[Knight]) || (Attacks::king[square] & enemy[King])
+        || (Attacks::pawn[target][square] & enemy[Pawn])
+        || (Attacks::rook(square, taken) & (enemy[Rook] | enemy[Queen]))
+        || (Attacks::bishop(square, taken) & (enemy[Bishop] | enemy[Queen]));
+}
 
-    return false;
+template <FigurePlayer side>
+void PathSystem::collectPaths(
+    const FiguresByType& figures, Bitboard own, Bitboard enemy,
+    multimap<PFigure, PPoint>& moves) const
+{
+#define COLLECT_PATHS(TYPE)                                                                        \
+    for (const auto& figure : figures[TYPE])                                                       \
+        for (const auto& point : toPoints(buildPathFor<side, TYPE>(figure, own, enemy)))           \
+            moves.insert({figure, point});
+
+    COLLECT_PATHS(Pawn);
+    COLLECT_PATHS(Rook);
+    COLLECT_PATHS(Knight);
+    COLLECT_PATHS(Bishop);
+    COLLECT_PATHS(Queen);
+    COLLECT_PATHS(King);
+#undef COLLECT_PATHS
 }
 
 multimap<PFigure, PPoint> PathSystem::getRawListOfMoves(FigurePlayer side) const
 {
-    // ally & enemy figures
-    set<PFigure> allies, enemies;
+    // the only runtime branch on side for the whole position
+    return side == Whites ? getRawListOfMovesFor<Whites>() : getRawListOfMovesFor<Blacks>();
+}
+
+template <FigurePlayer side>
+multimap<PFigure, PPoint> PathSystem::getRawListOfMovesFor() const
+{
+    constexpr auto enemySide = SideTraits<side>::enemy;
+
+    // ally figures
+    FiguresByType allies;
     PFigure ourKing;
 
     for (const auto& i : board) {
-        if (!i->isAlive())
+        if (!i->isAlive() || i->getPlayer() != side)
             continue;
-        if (i->getPlayer() == side) {
-            allies.insert(i);
-            if (i->isKing())
-                ourKing = i;
-        } else
-            enemies.insert(i);
+        allies[i->getType()].push_back(i);
+        if (i->isKing())
+            ourKing = i;
     }
 
     if (!ourKing) { // Are we in testing mode?
         throw runtime_error("two kings must be at board!");
     }
 
+    const auto own = occupancy(side);
+    const auto enemy = occupancy(enemySide);
+
     // build moves map
     set<PPoint> interceptionPoint;
     multimap<PFigure, PPoint> allyForces;
@@ -386,108 +416,73 @@ multimap<PFigure, PPoint> PathSystem::getRawListOfMoves(FigurePlayer side) const
         return tracedPath;
     };
 
-    for (const auto& i : enemies)
-        // look for our king's position
-        for (const auto& pos : buildPath(i))
-            if (*pos == *ourKing->getPoint()) {
-                // trace back path from king to attacker
-                auto tracedPoints = traceBack(i);
-                interceptionPoint.insert(tracedPoints.begin(), tracedPoints.end());
-                break;
-            }
-
-    for (const auto& i : allies) {
-        auto path = buildPath(i); // look for protection
-
-        for (const auto& pos : path) {
-            bool isInWanted
-                = interceptionPoint.empty(); // if no checkmate set - we want all the moves
-            // look for 'pos' in interceptionPoints
-            if (!isInWanted) {
-                for (const auto& want : interceptionPoint) {
-                    isInWanted = i->isKing() ? (!!at(want)) : (*want == *pos);
-                    if (isInWanted)
-                        break;
-                }
-            }
+    // checkers are found from the king's square backwards, enemy moves are not generated
+    const auto kingSquare = Attacks::square(ourKing->getX(), ourKing->getY());
+    const auto checkers = attackersTo(kingSquare) & enemy;
+    for (auto left = checkers; left;) {
+        // trace back path from king to attacker
+        auto tracedPoints = traceBack(squares[Attacks::popLowest(left)]);
+        interceptionPoint.insert(tracedPoints.begin(), tracedPoints.end());
+    }
+
+    collectPaths<side>(allies, own, enemy, allyForces); // look for protection
+    if (interceptionPoint.empty()) // if no checkmate set - we want all the moves
+        return allyForces;
 
+    multimap<PFigure, PPoint> wantedForces;
+    for (const auto& i : allyForces) {
+        // en passant lands behind the checking pawn it takes
+        const auto from = Attacks::square(i.first->getX(), i.first->getY());
+        const auto to = Attacks::square(i.second->getX(), i.second->getY());
+        if (i.first->isPawn() && to == enPassant && to % 8 != from % 8
+            && checkers & Bitboard(1) << (to + (from < to ? -8 : 8))) {
+            wantedForces.insert(i);
+            continue;
+        }
+
+        // look for 'pos' in interceptionPoints
+        bool isInWanted = false;
+        for (const auto& want : interceptionPoint) {
+            isInWanted = i.first->isKing() ? (!!at(want)) : (*want == *i.second);
             if (isInWanted)
-                allyForces.insert({i, pos});
+                break;
         }
+
+        if (isInWanted)
+            wantedForces.insert(i);
     }
-    return allyForces;
+    return wantedForces;
 }
 
 multimap<PFigure, PPoint> PathSystem::getListOfAvailableMoves(FigurePlayer side) const
 {
-    auto oppositeSide = side == Whites ? Blacks : Whites;
-    auto allyForces = getRawListOfMoves(side);
+    if (!getKing(side))
+        throw runtime_error("two kings must be at board!");
 
-    // simulation of one turn
+    // every move is played on a private copy of placement, figures are only read
+    multimap<PFigure, PPoint> legalMoves;
+    for (const auto& i : getRawListOfMoves(side))
+        if (keepsKingSafe(i.first, Attacks::square(i.second->getX(), i.second->getY())))
+            legalMoves.insert(i);
+    return legalMoves;
+}
 
+bool PathSystem::isInCheck(FigurePlayer side) const
+{
     auto king = getKing(side);
     if (!king)
-        throw runtime_error("two kings must be at board!");
-
-    multimap<PFigure, PPoint> filteredAllies, doubleFilteredAllies;
-
-    for (const auto& i : allyForces) {
-        const auto& figure = i.first;
-        const auto& spot = i.second;
-        const auto figurePos = make_shared<Point>(*figure->getPoint());
-
-        auto possibleFigure = at(spot);
-        if (possibleFigure)
-            possibleFigure->isCapturedBy(figure);
-
-        figure->getPoint()->setX(spot->getX());
-        figure->getPoint()->setY(spot->getY());
-
-        bool futureBlock = false;
-        auto enemyTurns = getRawListOfMoves(oppositeSide);
-
-        for (const auto& enemyPair : enemyTurns) {
-            auto enemyFigure = enemyPair.first;
-            auto enemyTurn = enemyPair.second;
-            if (*enemyTurn == *king->getPoint()) {
-                futureBlock = true;
-                break;
-            }
-        }
-
-        if (!futureBlock)
-            filteredAllies.insert({figure, spot});
-
-        if (possibleFigure)
-            possibleFigure->revive();
-        figure->getPoint()->setX(figurePos->getX());
-        figure->getPoint()->setY(figurePos->getY());
-    }
-
-    const auto leftCastlePoint = Point(king->getX() - 2, king->getY());
-    const auto rightCastlePoint = Point(king->getX() + 2, king->getY());
-    bool kingCanCastleLeft = false, kingCanCastleRight = false;
-
-    for (const auto& i : filteredAllies)
-        if (*i.first == *king && *(i.first->getPoint()) == *king->getPoint()) {
-            if (*i.second == rightCastlePoint)
-                kingCanCastleRight = true;
-            else if (*i.second == leftCastlePoint)
-                kingCanCastleLeft = true;
-        }
+        return false;
+    return isAttacked(Attacks::square(king->getX(), king->getY()), side == Whites ? Blacks : Whites);
+}
 
-    for (const auto& i : filteredAllies) {
-        const auto& figure = i.first;
-        const bool kingCanCastle
-            = figure->getX() < king->getX() ? kingCanCastleLeft : kingCanCastleRight;
-        const bool isKingNow = *i.first == *king && *(i.first->getPoint()) == *(king->getPoint());
-        const bool toInsert = isKingNow
-            || (figure->isReadyForCastling() ? checkCastling(figure, king) && kingCanCastle : true);
-        if (i.second && toInsert)
-            doubleFilteredAllies.insert(i);
-    }
+bool PathSystem::isAttacked(int square, FigurePlayer by) const
+{
+    return isAttacked(square, by, placement());
+}
 
-    return doubleFilteredAllies;
+Bitboard PathSystem::attackersTo(int square) const
+{
+    return attackersTo(square, placement());
 }
 
 PFigure PathSystem::getKing(FigurePlayer side) const
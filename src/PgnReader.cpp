@@ -0,0 +1,308 @@
+#include <Chessboard.h>
+#include <Fen.h>
+#include <MappedFile.h>
+#include <Move.h>
+#include <PgnReader.h>
+#include <Point.h>
+#include <San.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+bool isSpace(char ch)
+{
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t';
+}
+
+/// characters ending a movetext token besides spaces
+bool isDelimiter(char ch)
+{
+    return isSpace(ch) || ch == '{' || ch == '}' || ch == '(' || ch == ')' || ch == '['
+        || ch == ';';
+}
+
+bool isResult(string_view token)
+{
+    return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+}
+
+/// collects one game at a time and hands finished ones to the callback
+class GameBuilder {
+    const PgnReader::Callback& callback;
+    PgnStats& stats;
+    PgnGame game;
+    bool inMoves = false;
+    bool failed = false;
+    std::uint64_t moves = 0;
+
+    void begin()
+    {
+        inMoves = true;
+        try {
+            const auto fen = game.tag("FEN");
+            if (fen.empty()) {
+                game.board = make_shared<Chessboard>();
+                game.board->initialize();
+            } else {
+                game.board = make_shared<Chessboard>(Fen::parse(fen));
+            }
+        } catch (std::exception&) {
+            failed = true;
+        }
+    }
+
+public:
+    GameBuilder(const PgnReader::Callback& c, PgnStats& s)
+        : callback(c)
+        , stats(s)
+    {
+    }
+
+    bool isPlaying() const
+    {
+        return inMoves;
+    }
+
+    void tag(string_view name, string_view value)
+    {
+        game.tags.emplace_back(name, value);
+    }
+
+    void move(string_view san)
+    {
+        if (!inMoves)
+            begin();
+        if (failed)
+            return;
+        try {
+            auto& board = *game.board;
+            const auto move = San::parse(board, san);
+            if (!board.prepareMove(make_shared<Point>(move.getFrom()),
+                                   make_shared<Point>(move.getTo()), move.getPromotion())) {
+                failed = true;
+                return;
+            }
+            board.setTurn(!board.getWhitesTurn());
+            ++moves;
+        } catch (std::exception&) {
+            failed = true;
+        }
+    }
+
+    void finish(string_view result)
+    {
+        if (!inMoves && game.tags.empty())
+            return;
+        if (!inMoves)
+            begin();
+
+        if (failed) {
+            ++stats.skipped;
+        } else {
+            game.result = result;
+            callback(game);
+            ++stats.games;
+            stats.moves += moves;
+        }
+
+        // tags keep their capacity for the next game
+        game.tags.clear();
+        game.board = nullptr;
+        game.result = {};
+        inMoves = failed = false;
+        moves = 0;
+    }
+};
+
+} // namespace
+
+string_view PgnGame::tag(string_view name) const
+{
+    for (const auto& i : tags)
+        if (i.first == name)
+            return i.second;
+    return {};
+}
+
+double PgnStats::gamesPerSecond() const
+{
+    return seconds > 0 ? games / seconds : 0;
+}
+
+double PgnStats::megabytesPerSecond() const
+{
+    return seconds > 0 ? bytes / seconds / (1024 * 1024) : 0;
+}
+
+string PgnStats::asString() const
+{
+    ostringstream summary;
+    summary << "===========================\n";
+    summary << "Games read      : " << games << "\n";
+    summary << "Games skipped   : " << skipped << "\n";
+    summary << "Moves played    : " << moves << "\n";
+    summary << "Total time (ms) : " << (uint64_t)(seconds * 1000) << "\n";
+    summary << "Games/second    : " << (uint64_t)gamesPerSecond() << "\n";
+    summary << "MB/second       : " << megabytesPerSecond();
+    return summary.str();
+}
+
+PgnReader::PgnReader(unsigned int t)
+    : threads(max(t, 1u))
+{
+}
+
+PgnStats PgnReader::readFile(const string& fileName, const Callback& callback) const
+{
+    MappedFile file(fileName);
+    return read(string_view((const char*)file.getData(), file.getSize()), callback);
+}
+
+PgnStats PgnReader::read(string_view text, const Callback& callback) const
+{
+    auto start = chrono::steady_clock::now();
+
+    // every part starts at a tag section, so no game is cut in two
+    vector<size_t> bounds{0};
+    for (unsigned int i = 1; i < threads; ++i)
+        bounds.push_back(max(bounds.back(), nextGameStart(text, text.size() / threads * i)));
+    bounds.push_back(text.size());
+
+    PgnStats total;
+    if (bounds.size() == 2) {
+        total = readPart(text, callback);
+    } else {
+        vector<PgnStats> parts(bounds.size() - 1);
+        vector<thread> workers;
+        for (size_t i = 0; i < parts.size(); ++i)
+            workers.emplace_back([&, i] {
+                parts[i] = readPart(text.substr(bounds[i], bounds[i + 1] - bounds[i]), callback);
+            });
+        for (auto& worker : workers)
+            worker.join();
+
+        for (const auto& part : parts) {
+            total.games += part.games;
+            total.skipped += part.skipped;
+            total.moves += part.moves;
+        }
+    }
+
+    total.bytes = text.size();
+    total.seconds
+        = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    return total;
+}
+
+size_t PgnReader::nextGameStart(string_view text, size_t from)
+{
+    // a tag line that follows an empty line, which is how every exporter separates games
+    for (auto found = text.find("\n[", from); found != string_view::npos;
+         found = text.find("\n[", found + 1)) {
+        auto lineEnd = found;
+        while (lineEnd > 0 && text[lineEnd - 1] == '\r')
+            --lineEnd;
+        if (lineEnd > 0 && text[lineEnd - 1] == '\n')
+            return found + 1;
+    }
+    return text.size();
+}
+
+PgnStats PgnReader::readPart(string_view text, const Callback& callback)
+{
+    PgnStats stats;
+    GameBuilder builder(callback, stats);
+
+    size_t pos = 0;
+    const size_t size = text.size();
+    auto skipTo = [&](char end) {
+        pos = text.find(end, pos);
+        pos = pos == string_view::npos ? size : pos + 1;
+    };
+
+    while (pos < size) {
+        const char ch = text[pos];
+        if (isSpace(ch)) {
+            ++pos;
+        } else if (ch == '[') {
+            // a tag section without a result before it still ends the game
+            if (builder.isPlaying())
+                builder.finish({});
+
+            size_t nameStart = pos + 1;
+            while (nameStart < size && isSpace(text[nameStart]))
+                ++nameStart;
+            size_t nameEnd = nameStart;
+            while (nameEnd < size && !isSpace(text[nameEnd]) && text[nameEnd] != '"'
+                   && text[nameEnd] != ']')
+                ++nameEnd;
+
+            size_t valueStart = text.find_first_of("\"]", nameEnd);
+            if (valueStart == string_view::npos || text[valueStart] == ']') {
+                pos = valueStart == string_view::npos ? size : valueStart + 1;
+                continue;
+            }
+            size_t valueEnd = ++valueStart;
+            while (valueEnd < size && text[valueEnd] != '"')
+                valueEnd += text[valueEnd] == '\\' ? 2 : 1;
+            valueEnd = min(valueEnd, size);
+
+            builder.tag(text.substr(nameStart, nameEnd - nameStart),
+                        text.substr(valueStart, valueEnd - valueStart));
+            pos = valueEnd;
+            skipTo(']');
+        } else if (ch == '{') {
+            skipTo('}');
+        } else if (ch == ';' || (ch == '%' && (pos == 0 || text[pos - 1] == '\n'))) {
+            skipTo('\n');
+        } else if (ch == '(') {
+            // variations may nest, none of their moves are played
+            int depth = 0;
+            for (; pos < size; ++pos) {
+                if (text[pos] == '{') {
+                    skipTo('}');
+                    --pos;
+                } else if (text[pos] == '(') {
+                    ++depth;
+                } else if (text[pos] == ')' && --depth == 0) {
+                    ++pos;
+                    break;
+                }
+            }
+        } else if (ch == ')' || ch == '}' || ch == ']') {
+            ++pos;
+        } else {
+            const size_t start = pos;
+            while (pos < size && !isDelimiter(text[pos]))
+                ++pos;
+            auto token = text.substr(start, pos - start);
+
+            if (isResult(token)) {
+                builder.finish(token);
+                continue;
+            }
+            if (token.front() == '$') // numeric annotation glyph
+                continue;
+            // move numbers may be glued to the move: "12.e4", "12...e5", but "0-0" is castling
+            const auto digits = token.find_first_not_of("0123456789");
+            if (digits != 0 && digits != string_view::npos && token[digits] == '.') {
+                token.remove_prefix(digits);
+                while (!token.empty() && token.front() == '.')
+                    token.remove_prefix(1);
+            } else if (digits == string_view::npos) {
+                continue;
+            }
+            if (!token.empty())
+                builder.move(token);
+        }
+    }
+    builder.finish({});
+    return stats;
+}
@@ -0,0 +1,150 @@
+#include <BoardSnapshot.h>
+#include <Chessboard.h>
+#include <Fen.h>
+#include <Move.h>
+#include <PgnWriter.h>
+#include <Point.h>
+#include <San.h>
+
+#include <charconv>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const size_t maxLineLength = 80;
+
+const string_view rosterTags[] = {"Event", "Site", "Date", "Round", "White", "Black"};
+
+} // namespace
+
+string_view PgnWriter::resultOf(const Chessboard& board)
+{
+    const auto side = board.getWhitesTurn() ? Whites : Blacks;
+    if (!board.hasAnyLegalMove(side)) {
+        if (!board.isInCheck(side))
+            return "1/2-1/2";
+        return side == Whites ? "0-1" : "1-0";
+    }
+    if (board.isThreefoldRepetition() || board.isFiftyMoveRule() || board.hasInsufficientMaterial())
+        return "1/2-1/2";
+    return "*";
+}
+
+void PgnWriter::appendTag(string_view name, string_view value)
+{
+    buffer += '[';
+    buffer += name;
+    buffer += " \"";
+    for (char ch : value) {
+        if (ch == '"' || ch == '\\')
+            buffer += '\\';
+        buffer += ch;
+    }
+    buffer += "\"]\n";
+}
+
+void PgnWriter::appendToken(string_view token)
+{
+    if (buffer.size() > lineStart) {
+        if (buffer.size() - lineStart + 1 + token.size() > maxLineLength) {
+            buffer += '\n';
+            lineStart = buffer.size();
+        } else {
+            buffer += ' ';
+        }
+    }
+    buffer += token;
+}
+
+void PgnWriter::write(const Chessboard& board, const Tags& tags, string_view result)
+{
+    if (result.empty())
+        result = resultOf(board);
+
+    auto tagOf = [&tags](string_view name) -> string_view {
+        for (const auto& i : tags)
+            if (i.first == name)
+                return i.second;
+        return {};
+    };
+
+    for (auto name : rosterTags) {
+        const auto value = tagOf(name);
+        appendTag(name, value.empty() ? "?" : value);
+    }
+    appendTag("Result", result);
+
+    // games that do not start from the usual position carry it along
+    const auto start = board.getStartPosition();
+    Chessboard replay(start);
+    const auto startFen = replay.toFen();
+    if (startFen != Fen::StartPosition) {
+        appendTag("SetUp", "1");
+        appendTag("FEN", startFen);
+    }
+
+    for (const auto& i : tags) {
+        bool known = i.first == "Result" || i.first == "SetUp" || i.first == "FEN";
+        for (auto name : rosterTags)
+            known |= i.first == name;
+        if (!known)
+            appendTag(i.first, i.second);
+    }
+    buffer += '\n';
+    lineStart = buffer.size();
+
+    // numbers and san are put together on the stack, only the buffer grows
+    char number[16];
+    string san;
+    san.reserve(16);
+    unsigned int moveNumber = start.getPly() / 2 + 1;
+    bool first = true;
+    for (const auto& move : board.getMoves()) {
+        const bool whites = replay.getWhitesTurn();
+        if (whites || first) {
+            auto end = to_chars(number, number + sizeof(number) - 3, moveNumber).ptr;
+            for (int dots = whites ? 1 : 3; dots; --dots)
+                *end++ = '.';
+            appendToken(string_view(number, end - number));
+        }
+        first = false;
+
+        san.clear();
+        San::write(replay, move, san);
+        if (!replay.prepareMove(make_shared<Point>(move.getFrom()), make_shared<Point>(move.getTo()),
+                                move.getPromotion()))
+            throw runtime_error("Recorded move cannot be played " + move.asString());
+        replay.setTurn(!whites);
+        if (!whites)
+            ++moveNumber;
+
+        const auto side = replay.getWhitesTurn() ? Whites : Blacks;
+        if (replay.isInCheck(side))
+            san += replay.hasAnyLegalMove(side) ? '+' : '#';
+        appendToken(san);
+    }
+
+    appendToken(result);
+    buffer += "\n\n";
+    lineStart = buffer.size();
+}
+
+const string& PgnWriter::getBuffer() const
+{
+    return buffer;
+}
+
+void PgnWriter::clear()
+{
+    buffer.clear();
+    lineStart = 0;
+}
+
+void PgnWriter::flush(ostream& stream)
+{
+    stream.write(buffer.data(), (streamsize)buffer.size());
+    clear();
+}
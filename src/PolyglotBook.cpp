@@ -0,0 +1,239 @@
+#include <BoardSnapshot.h>
+#include <Bytes.h>
+#include <Chessboard.h>
+#include <Figure.h>
+#include <MappedFile.h>
+#include <Move.h>
+#include <Point.h>
+#include <PolyglotBook.h>
+#include <PolyglotRandom.h>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const size_t castlingOffset = 768;
+const size_t enPassantOffset = 772;
+const size_t turnOffset = 780;
+
+/// Polyglot figure kind order by FigureType: pawn, knight, bishop, rook, queen, king
+const unsigned int polyglotType[] = {0, 3, 1, 2, 4, 5};
+/// FigureType by Polyglot promotion code, 0 stands for no promotion
+const FigureType promotionType[] = {Queen, Knight, Bishop, Rook, Queen};
+
+[[noreturn]] void badKeys()
+{
+    throw runtime_error("Got bad formatted polyglot keys");
+}
+
+bool isCastling(const BoardSnapshot& snapshot, int from, int to)
+{
+    return (from == 4 || from == 60) && from / 8 == to / 8 && !snapshot.isEmpty(from)
+        && snapshot.getType(from) == King;
+}
+
+} // namespace
+
+PolyglotKeys::PolyglotKeys()
+    : random(PolyglotRandom::keys)
+{
+}
+
+PolyglotKeys PolyglotKeys::load(const string& fileName)
+{
+    ifstream file(fileName);
+    if (!file.is_open())
+        throw runtime_error("Couldn't open " + fileName);
+    stringstream text;
+    text << file.rdbuf();
+    const auto s = text.str();
+
+    PolyglotKeys keys;
+    size_t count = 0;
+    for (size_t i = s.find("0x"); i != string::npos; i = s.find("0x", i)) {
+        i += 2;
+        uint64_t key = 0;
+        size_t digits = 0;
+        for (; i < s.size() && isxdigit((unsigned char)s[i]); ++i, ++digits) {
+            const char c = (char)tolower((unsigned char)s[i]);
+            key = key << 4 | (uint64_t)(c <= '9' ? c - '0' : c - 'a' + 10);
+        }
+        if (!digits || digits > 16 || count == Size)
+            badKeys();
+        keys.random[count++] = key;
+    }
+    if (count != Size)
+        badKeys();
+    return keys;
+}
+
+uint64_t PolyglotKeys::hash(const BoardSnapshot& snapshot) const
+{
+    uint64_t key = 0;
+    for (int square = 0; square < 64; ++square) {
+        if (snapshot.isEmpty(square))
+            continue;
+        const auto kind
+            = 2 * polyglotType[snapshot.getType(square)] + (snapshot.getPlayer(square) == Whites);
+        key ^= random[64 * kind + square];
+    }
+
+    // our rights are ordered just like Polyglot's
+    for (unsigned int i = 0; i < 4; ++i)
+        if (snapshot.getCastling() & (1 << i))
+            key ^= random[castlingOffset + i];
+
+    const auto enPassant = snapshot.getEnPassant();
+    if (enPassant != BoardSnapshot::NoEnPassant) {
+        // the pawn that went two squares stands next to the capturers
+        const int x = enPassant % 8, y = enPassant / 8 == 2 ? 3 : 4;
+        const auto pawn
+            = BoardSnapshot::code(Pawn, snapshot.getWhitesTurn() ? Whites : Blacks);
+        if ((x > 0 && snapshot.get(y * 8 + x - 1) == pawn)
+            || (x < 7 && snapshot.get(y * 8 + x + 1) == pawn))
+            key ^= random[enPassantOffset + x];
+    }
+
+    if (snapshot.getWhitesTurn())
+        key ^= random[turnOffset];
+    return key;
+}
+
+uint64_t PolyglotKeys::hash(const Chessboard& board) const
+{
+    return hash(board.snapshot());
+}
+
+uint16_t PolyglotKeys::encode(const BoardSnapshot& snapshot, const Move& move)
+{
+    const auto from = move.getFrom(), to = move.getTo();
+    const int fromSquare = (int)(from.getY() * 8 + from.getX());
+    int toX = (int)to.getX();
+    const int distance = toX - (int)from.getX();
+    if (isCastling(snapshot, fromSquare, (int)(to.getY() * 8 + to.getX()))
+        && (distance == 2 || distance == -2))
+        toX = distance > 0 ? 7 : 0;
+
+    unsigned int promotion = 0;
+    if (!snapshot.isEmpty(fromSquare) && snapshot.getType(fromSquare) == Pawn
+        && (to.getY() == 0 || to.getY() == 7)) {
+        switch (move.getPromotion()) {
+        case Knight:
+            promotion = 1;
+            break;
+        case Bishop:
+            promotion = 2;
+            break;
+        case Rook:
+            promotion = 3;
+            break;
+        default:
+            promotion = 4;
+        }
+    }
+    return (uint16_t)(toX | to.getY() << 3 | from.getX() << 6 | from.getY() << 9
+                      | promotion << 12);
+}
+
+Move PolyglotKeys::decode(const BoardSnapshot& snapshot, uint16_t move)
+{
+    Point from(move >> 6 & 7, move >> 9 & 7);
+    Point to(move & 7, move >> 3 & 7);
+    const auto promotion = (unsigned int)(move >> 12 & 7);
+    if (promotion >= sizeof(promotionType) / sizeof(*promotionType))
+        throw invalid_argument("Got bad formatted book move");
+
+    const int fromSquare = (int)(from.getY() * 8 + from.getX());
+    const int toSquare = (int)(to.getY() * 8 + to.getX());
+    if (isCastling(snapshot, fromSquare, toSquare) && (to.getX() == 7 || to.getX() == 0)
+        && !snapshot.isEmpty(toSquare) && snapshot.getType(toSquare) == Rook
+        && snapshot.getPlayer(toSquare) == snapshot.getPlayer(fromSquare))
+        to.setX(to.getX() == 7 ? 6 : 2);
+    return Move(from, to, promotionType[promotion]);
+}
+
+PolyglotBook::PolyglotBook(const string& fileName, PolyglotKeys k, Selection s)
+    : file(fileName)
+    , keys(k)
+    , selection(s)
+    , entryCount(file.getSize() / EntrySize)
+    , random(random_device()())
+{
+    if (file.getSize() % EntrySize)
+        throw runtime_error("Got bad formatted opening book");
+}
+
+vector<BookEntry> PolyglotBook::find(const Chessboard& board) const
+{
+    vector<BookEntry> entries;
+    if (!entryCount)
+        return entries;
+
+    const auto snapshot = board.snapshot();
+    const auto key = keys.hash(snapshot);
+    const auto* data = file.getData();
+    size_t low = 0, high = entryCount;
+    while (low < high) {
+        const auto middle = low + (high - low) / 2;
+        if (Bytes::loadBig<uint64_t>(data + middle * EntrySize) < key)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    // entries can be stale or come from a colliding position, only legal moves are kept
+    const auto legal = board.listMoves(snapshot.getWhitesTurn() ? Whites : Blacks);
+    for (const auto* entry = data + low * EntrySize;
+         entry != data + entryCount * EntrySize && Bytes::loadBig<uint64_t>(entry) == key;
+         entry += EntrySize) {
+        BookEntry found;
+        try {
+            found.move = PolyglotKeys::decode(snapshot, Bytes::loadBig<uint16_t>(entry + 8));
+        } catch (invalid_argument&) {
+            continue;
+        }
+        if (std::find(legal.begin(), legal.end(), found.move) == legal.end())
+            continue;
+        found.weight = Bytes::loadBig<uint16_t>(entry + 10);
+        found.learn = Bytes::loadBig<uint32_t>(entry + 12);
+        entries.push_back(found);
+    }
+    stable_sort(entries.begin(), entries.end(),
+                [](const BookEntry& a, const BookEntry& b) { return a.weight > b.weight; });
+    return entries;
+}
+
+bool PolyglotBook::pick(const Chessboard& board, Move& move)
+{
+    const auto entries = find(board);
+    uint64_t total = 0;
+    for (const auto& entry : entries)
+        total += entry.weight;
+    if (!total)
+        return false;
+
+    if (selection == Best) {
+        move = entries.front().move;
+        return true;
+    }
+    auto left = uniform_int_distribution<uint64_t>(0, total - 1)(random);
+    for (const auto& entry : entries) {
+        if (left < entry.weight) {
+            move = entry.move;
+            return true;
+        }
+        left -= entry.weight;
+    }
+    return false;
+}
+
+size_t PolyglotBook::size() const
+{
+    return entryCount;
+}
@@ -0,0 +1,236 @@
+#include <Bytes.h>
+#include <Chessboard.h>
+#include <MappedFile.h>
+#include <Move.h>
+#include <Point.h>
+#include <PositionDb.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+
+using namespace std;
+
+namespace {
+
+// file layout, all numbers are little endian:
+//   header: magic, version (2), index bits (2), position count (8), move count (8), reserved (8)
+//   index: 2^bits + 1 position numbers (8), slot i starts the positions whose
+//   hash begins with i in its top bits
+//   positions: hash (8), Whites won (4), draws (4), Blacks won (4),
+//   first move (4), move count (4), reserved (4)
+//   moves: from, to, promotion, reserved, count (4)
+const char dbMagic[4] = {'C', 'H', 'S', 'D'};
+const uint16_t dbVersion = 1;
+const size_t headerSize = 32;
+const size_t positionSize = 32;
+const size_t moveSize = 8;
+/// positions per index slot the builder aims at
+const uint64_t positionsPerSlot = 64;
+const unsigned int maxIndexBits = 24;
+
+[[noreturn]] void badDb()
+{
+    throw runtime_error("Got bad formatted position database");
+}
+
+uint64_t slotOf(uint64_t hash, unsigned int bits)
+{
+    return bits ? hash >> (64 - bits) : 0;
+}
+
+/// from | to << 6 | promotion << 12, as records keep moves
+uint16_t packMove(const Move& move)
+{
+    const auto from = move.getFrom(), to = move.getTo();
+    return (uint16_t)((from.getY() * 8 + from.getX()) | (to.getY() * 8 + to.getX()) << 6
+                      | move.getPromotion() << 12);
+}
+
+} // namespace
+
+uint32_t PositionStats::games() const
+{
+    return whitesWon + draws + blacksWon;
+}
+
+bool PositionDbBuilder::addGame(const Chessboard& board, string_view result)
+{
+    uint8_t outcome;
+    if (result == "1-0")
+        outcome = 0;
+    else if (result == "1/2-1/2")
+        outcome = 1;
+    else if (result == "0-1")
+        outcome = 2;
+    else
+        return false;
+
+    // a position met again in the same game is not counted twice
+    unordered_set<uint64_t> seen;
+    Chessboard replay(board.getStartPosition());
+    for (const auto& move : board.getMoves()) {
+        if (seen.insert(replay.getHash()).second)
+            records.push_back({replay.getHash(), packMove(move), outcome});
+        if (!replay.prepareMove(make_shared<Point>(move.getFrom()), make_shared<Point>(move.getTo()),
+                                move.getPromotion()))
+            throw runtime_error("Recorded move cannot be played " + move.asString());
+        replay.setTurn(!replay.getWhitesTurn());
+    }
+    if (seen.insert(replay.getHash()).second)
+        records.push_back({replay.getHash(), NoMove, outcome});
+    return true;
+}
+
+size_t PositionDbBuilder::size() const
+{
+    return records.size();
+}
+
+void PositionDbBuilder::write(const string& fileName)
+{
+    // sorting puts every occurrence of a position and of its moves side by side
+    sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.move < b.move;
+    });
+
+    struct MoveCount {
+        uint16_t move;
+        uint32_t count;
+    };
+    vector<uint8_t> positionData, moveData;
+    vector<uint64_t> hashes;
+    vector<MoveCount> positionMoves;
+    for (size_t i = 0; i < records.size();) {
+        const auto hash = records[i].hash;
+        uint32_t results[3] = {0, 0, 0};
+        positionMoves.clear();
+        for (; i < records.size() && records[i].hash == hash; ++i) {
+            ++results[records[i].result];
+            if (records[i].move == NoMove)
+                continue;
+            if (positionMoves.empty() || positionMoves.back().move != records[i].move)
+                positionMoves.push_back({records[i].move, 0});
+            ++positionMoves.back().count;
+        }
+        stable_sort(positionMoves.begin(), positionMoves.end(),
+                    [](const MoveCount& a, const MoveCount& b) { return a.count > b.count; });
+
+        uint8_t position[positionSize] = {};
+        Bytes::storeLittle(position, hash);
+        Bytes::storeLittle(position + 8, results[0]);
+        Bytes::storeLittle(position + 12, results[1]);
+        Bytes::storeLittle(position + 16, results[2]);
+        Bytes::storeLittle(position + 20, (uint32_t)(moveData.size() / moveSize));
+        Bytes::storeLittle(position + 24, (uint32_t)positionMoves.size());
+        positionData.insert(positionData.end(), position, position + positionSize);
+        hashes.push_back(hash);
+
+        for (const auto& i : positionMoves) {
+            uint8_t move[moveSize] = {(uint8_t)(i.move & 63), (uint8_t)(i.move >> 6 & 63),
+                                      (uint8_t)(i.move >> 12)};
+            Bytes::storeLittle(move + 4, i.count);
+            moveData.insert(moveData.end(), move, move + moveSize);
+        }
+    }
+
+    unsigned int bits = 0;
+    while (bits < maxIndexBits && (hashes.size() >> bits) > positionsPerSlot)
+        ++bits;
+    vector<uint8_t> indexData(((size_t(1) << bits) + 1) * 8);
+    size_t position = 0;
+    for (uint64_t slot = 0; slot <= (uint64_t(1) << bits); ++slot) {
+        while (position < hashes.size() && slotOf(hashes[position], bits) < slot)
+            ++position;
+        Bytes::storeLittle(indexData.data() + slot * 8, (uint64_t)position);
+    }
+
+    uint8_t header[headerSize] = {};
+    memcpy(header, dbMagic, sizeof(dbMagic));
+    Bytes::storeLittle(header + 4, dbVersion);
+    Bytes::storeLittle(header + 6, (uint16_t)bits);
+    Bytes::storeLittle(header + 8, (uint64_t)hashes.size());
+    Bytes::storeLittle(header + 16, (uint64_t)(moveData.size() / moveSize));
+
+    ofstream file(fileName, ios::binary);
+    if (!file.is_open())
+        throw runtime_error("Couldn't write to " + fileName);
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)indexData.data(), (streamsize)indexData.size());
+    file.write((const char*)positionData.data(), (streamsize)positionData.size());
+    file.write((const char*)moveData.data(), (streamsize)moveData.size());
+    if (!file.flush())
+        throw runtime_error("Couldn't write to " + fileName);
+}
+
+PositionDb::PositionDb(const string& fileName)
+    : file(fileName)
+{
+    const auto* data = file.getData();
+    const auto size = file.getSize();
+    if (size < headerSize || memcmp(data, dbMagic, sizeof(dbMagic)) != 0
+        || Bytes::loadLittle<uint16_t>(data + 4) != dbVersion)
+        badDb();
+
+    indexBits = Bytes::loadLittle<uint16_t>(data + 6);
+    positionCount = Bytes::loadLittle<uint64_t>(data + 8);
+    moveCount = Bytes::loadLittle<uint64_t>(data + 16);
+    if (indexBits > maxIndexBits)
+        badDb();
+    const uint64_t indexSize = ((uint64_t(1) << indexBits) + 1) * 8;
+    // counts are checked one by one, so that broken ones cannot overflow the sum
+    const uint64_t rest = size - headerSize;
+    if (indexSize > rest || positionCount > (rest - indexSize) / positionSize
+        || moveCount > (rest - indexSize - positionCount * positionSize) / moveSize)
+        badDb();
+
+    index = data + headerSize;
+    positions = index + indexSize;
+    moves = positions + positionCount * positionSize;
+}
+
+bool PositionDb::find(uint64_t hash, PositionStats& stats) const
+{
+    const auto slot = slotOf(hash, indexBits);
+    uint64_t low = Bytes::loadLittle<uint64_t>(index + slot * 8);
+    uint64_t high = Bytes::loadLittle<uint64_t>(index + slot * 8 + 8);
+    if (high > positionCount || low > high)
+        badDb();
+
+    while (low < high) {
+        const auto middle = low + (high - low) / 2;
+        if (Bytes::loadLittle<uint64_t>(positions + middle * positionSize) < hash)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == positionCount || Bytes::loadLittle<uint64_t>(positions + low * positionSize) != hash)
+        return false;
+
+    const auto* position = positions + low * positionSize;
+    stats.whitesWon = Bytes::loadLittle<uint32_t>(position + 8);
+    stats.draws = Bytes::loadLittle<uint32_t>(position + 12);
+    stats.blacksWon = Bytes::loadLittle<uint32_t>(position + 16);
+    const uint64_t first = Bytes::loadLittle<uint32_t>(position + 20);
+    const uint64_t count = Bytes::loadLittle<uint32_t>(position + 24);
+    if (first + count > moveCount)
+        badDb();
+
+    stats.moves.clear();
+    for (const auto* move = moves + first * moveSize; move != moves + (first + count) * moveSize;
+         move += moveSize)
+        stats.moves.emplace_back(Move::unpack(move), Bytes::loadLittle<uint32_t>(move + 4));
+    return true;
+}
+
+bool PositionDb::find(const Chessboard& board, PositionStats& stats) const
+{
+    return find(board.getHash(), stats);
+}
+
+uint64_t PositionDb::size() const
+{
+    return positionCount;
+}
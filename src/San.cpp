@@ -0,0 +1,190 @@
+#include <Chessboard.h>
+#include <Figure.h>
+#include <Move.h>
+#include <PathSystem.h>
+#include <Point.h>
+#include <San.h>
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+[[noreturn]] void badSan(string_view san, const char* reason)
+{
+    throw invalid_argument(string(reason) + ": " + string(san));
+}
+
+/// Pawn for anything but a figure letter
+FigureType figureOf(char letter)
+{
+    switch (letter) {
+    case 'R':
+        return Rook;
+    case 'N':
+        return Knight;
+    case 'B':
+        return Bishop;
+    case 'Q':
+        return Queen;
+    case 'K':
+        return King;
+    default:
+        return Pawn;
+    }
+}
+
+/// letters by FigureType, pawns have none
+const char figureLetters[] = " RNBQK";
+
+bool isFile(char ch)
+{
+    return ch >= 'a' && ch <= 'h';
+}
+
+bool isRank(char ch)
+{
+    return ch >= '1' && ch <= '8';
+}
+
+} // namespace
+
+Move San::parse(const Chessboard& board, string_view san)
+{
+    const auto side = board.getWhitesTurn() ? Whites : Blacks;
+    const unsigned int homeRank
+        = side == Whites ? SideTraits<Whites>::homeRank : SideTraits<Blacks>::homeRank;
+
+    // check marks and annotations say nothing about the move itself
+    auto text = san;
+    while (!text.empty() && string_view("+#!?").find(text.back()) != string_view::npos)
+        text.remove_suffix(1);
+
+    if (text == "O-O" || text == "0-0" || text == "O-O-O" || text == "0-0-0") {
+        const Move move(Point(SideTraits<Whites>::kingFile, homeRank),
+                        Point(text.size() == 3 ? 6 : 2, homeRank));
+        auto king = board.atSquare(Attacks::square(move.getFrom().getX(), homeRank));
+        if (!king || !king->isKing() || king->getPlayer() != side || !board.isLegal(move))
+            badSan(san, "Illegal move");
+        return move;
+    }
+
+    if (text.empty())
+        badSan(san, "Got bad formatted move");
+    const auto type = figureOf(text.front());
+    if (type != Pawn)
+        text.remove_prefix(1);
+
+    // "e8=Q" and "e8Q" are both in use
+    FigureType promotion = Queen;
+    if (!text.empty() && figureOf(text.back()) != Pawn && figureOf(text.back()) != King) {
+        if (type != Pawn)
+            badSan(san, "Got bad formatted move");
+        promotion = figureOf(text.back());
+        text.remove_suffix(1);
+        if (!text.empty() && text.back() == '=')
+            text.remove_suffix(1);
+    }
+
+    if (text.size() < 2 || !isFile(text[text.size() - 2]) || !isRank(text.back()))
+        badSan(san, "Got bad formatted move");
+    const int toX = text[text.size() - 2] - 'a', toY = text.back() - '1';
+    text.remove_suffix(2);
+
+    // what is left tells apart figures going to the same square
+    int fromX = -1, fromY = -1;
+    for (char ch : text) {
+        if (isFile(ch))
+            fromX = ch - 'a';
+        else if (isRank(ch))
+            fromY = ch - '1';
+        else if (ch != 'x' && ch != ':')
+            badSan(san, "Got bad formatted move");
+    }
+
+    // pawns only leave their file when capturing, and then the file is always written
+    if (type == Pawn && fromX < 0)
+        fromX = toX;
+
+    const auto target = board.atSquare(Attacks::square(toX, toY));
+    if (target && target->getPlayer() == side)
+        badSan(san, "Illegal move");
+
+    Move found;
+    unsigned int candidates = 0;
+    for (int square = 0; square < 64; ++square) {
+        const auto figure = board.atSquare(square);
+        if (!figure || figure->getPlayer() != side || figure->getType() != type
+            || (fromX >= 0 && square % 8 != fromX) || (fromY >= 0 && square / 8 != fromY))
+            continue;
+        const Move move(Point(square % 8, square / 8), Point(toX, toY), promotion);
+        if (board.isLegal(move)) {
+            found = move;
+            ++candidates;
+        }
+    }
+
+    if (!candidates)
+        badSan(san, "Illegal move");
+    if (candidates > 1)
+        badSan(san, "Ambiguous move");
+    return found;
+}
+
+void San::write(const Chessboard& board, const Move& move, string& out)
+{
+    const auto from = move.getFrom(), to = move.getTo();
+    const auto figure = board.atSquare(Attacks::square(from.getX(), from.getY()));
+    if (!figure)
+        throw invalid_argument("No figure to move at " + from.asString());
+
+    const auto type = figure->getType();
+    const int dx = (int)to.getX() - (int)from.getX();
+    if (type == King && (dx == 2 || dx == -2)) {
+        out += dx > 0 ? "O-O" : "O-O-O";
+        return;
+    }
+
+    const auto target = Attacks::square(to.getX(), to.getY());
+    const bool capture = board.atSquare(target)
+        || (type == Pawn && dx != 0); // en passant leaves the target empty
+
+    if (type == Pawn) {
+        if (capture) {
+            out += (char)('a' + from.getX());
+            out += 'x';
+        }
+    } else {
+        out += figureLetters[type];
+
+        // other figures of the same kind that may go to the same square
+        bool sameFile = false, sameRank = false, others = false;
+        for (int square = 0; square < 64; ++square) {
+            const auto other = board.atSquare(square);
+            if (!other || other == figure || other->getType() != type
+                || other->getPlayer() != figure->getPlayer()
+                || !board.isLegal(Move(Point(square % 8, square / 8), to)))
+                continue;
+            others = true;
+            sameFile |= square % 8 == (int)from.getX();
+            sameRank |= square / 8 == (int)from.getY();
+        }
+        if (others && (!sameFile || sameRank))
+            out += (char)('a' + from.getX());
+        if (others && sameFile)
+            out += (char)('1' + from.getY());
+
+        if (capture)
+            out += 'x';
+    }
+
+    out += (char)('a' + to.getX());
+    out += (char)('1' + to.getY());
+
+    if (board.isPromotion(move)) {
+        out += '=';
+        out += figureLetters[move.getPromotion()];
+    }
+}
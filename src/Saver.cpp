@@ -1,31 +1,124 @@
+#include <BoardSnapshot.h>
+#include <Bytes.h>
+#include <CaptureLog.h>
 #include <Chessboard.h>
 #include <Figure.h>
+#include <Journal.h>
+#include <MappedFile.h>
+#include <Move.h>
 #include <Point.h>
 #include <Saver.h>
 
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <system_error>
+#include <vector>
 
 using namespace std;
 
+namespace {
+
+const string captureLogTag = "captures";
+
+// binary savefile, all numbers are little endian:
+//   magic, version (2), reserved (2), packed BoardSnapshot,
+//   packed position the moves start from (since version 2),
+//   move count (4), then from, to and promotion byte per move
+const char binaryMagic[4] = {'C', 'H', 'S', 'B'};
+const uint16_t binaryVersion = 2;
+const size_t binaryHeaderSize = 8;
+
+[[noreturn]] void badSavefile()
+{
+    throw runtime_error("Got bad formatted savefile");
+}
+
+} // namespace
+
 PChessboard Saver::loadCheckboard() const
+{
+    {
+        MappedFile file(fileName);
+        if (file.getSize() >= sizeof(binaryMagic)
+            && memcmp(file.getData(), binaryMagic, sizeof(binaryMagic)) == 0)
+            return loadBinary(file.getData(), file.getSize());
+        if (Journal::isJournal(file.getData(), file.getSize()))
+            return Journal::replay(file.getData(), file.getSize());
+    }
+    return loadText();
+}
+
+PChessboard Saver::loadBinary(const uint8_t* data, size_t size)
+{
+    if (size < binaryHeaderSize)
+        badSavefile();
+    const auto version = Bytes::loadLittle<uint16_t>(data + 4);
+    // the first version kept no start position, so its moves cannot be replayed
+    const size_t positions = version == 1 ? 1 : 2;
+    if ((version != 1 && version != binaryVersion)
+        || size < binaryHeaderSize + positions * BoardSnapshot::PackedSize + 4)
+        badSavefile();
+    const auto snapshot = BoardSnapshot::unpack(data + binaryHeaderSize);
+    auto c = make_shared<Chessboard>(snapshot);
+    if (positions == 1)
+        return c;
+    const auto start = BoardSnapshot::unpack(data + binaryHeaderSize + BoardSnapshot::PackedSize);
+
+    const auto* moveData = data + binaryHeaderSize + positions * BoardSnapshot::PackedSize;
+    const uint32_t count = Bytes::loadLittle<uint32_t>(moveData);
+    moveData += 4;
+    if ((size - (moveData - data)) / Move::PackedSize < count)
+        badSavefile();
+
+    vector<Move> moves;
+    moves.reserve(count);
+    for (uint32_t i = 0; i < count; ++i, moveData += Move::PackedSize)
+        moves.push_back(Move::unpack(moveData));
+
+    c->setMoves(start, std::move(moves));
+    return c;
+}
+
+PChessboard Saver::loadText() const
 {
     ifstream file(fileName);
     if (!file.is_open()) // stream failed to read int data
         throw runtime_error("Couldn't open savefile");
 
     PFigures objects;
+    CaptureLog captures;
+    unsigned int ply = 0;
     string str;
     getline(file, str);
 
     bool turn = atoi(str.c_str());
     getline(file, str);
 
-    while (!file.eof()) {
+    // older savefiles have no capture log and keep killers inline
+    while (!file.eof() && str.compare(0, captureLogTag.size(), captureLogTag) != 0) {
         objects.push_back(restoreFigure(str));
         getline(file, str);
     }
-    auto c = make_shared<Chessboard>(objects);
+
+    if (!file.eof()) {
+        size_t count = 0;
+        istringstream header(str.substr(captureLogTag.size()));
+        header >> ply >> count;
+        if (header.fail())
+            throw runtime_error("Got bad formatted savefile");
+
+        for (size_t i = 0; i < count; ++i) {
+            unsigned int entryPly, captured, capturing;
+            int square;
+            if (!(file >> entryPly >> captured >> capturing >> square))
+                throw runtime_error("Got bad formatted savefile");
+            captures.record(entryPly, captured, capturing, square);
+        }
+    }
+
+    auto c = make_shared<Chessboard>(objects, captures, ply);
     c->setTurn(turn);
     return c;
 }
@@ -35,14 +128,72 @@ void Saver::saveCheckboard(const PChessboard& checkboard) const
     if (!checkboard)
         return;
 
-    ofstream file(fileName);
+    const auto temporary = fileName + ".tmp";
+    if (format == Binary)
+        saveBinary(checkboard, temporary);
+    else
+        saveText(checkboard, temporary);
+
+    error_code error;
+    filesystem::rename(temporary, fileName, error);
+    if (error) {
+        filesystem::remove(temporary, error);
+        throw runtime_error("Couldn't write to savefile");
+    }
+}
+
+void Saver::saveBinary(const PChessboard& checkboard, const string& target) const
+{
+    const auto snapshot = checkboard->snapshot();
+    const auto& moves = checkboard->getMoves();
+
+    // the whole file is built in memory and written at once
+    string out;
+    out.reserve(binaryHeaderSize + 2 * BoardSnapshot::PackedSize + 4
+                + moves.size() * Move::PackedSize);
+    uint8_t header[binaryHeaderSize] = {};
+    memcpy(header, binaryMagic, sizeof(binaryMagic));
+    Bytes::storeLittle(header + 4, binaryVersion);
+    out.append((const char*)header, sizeof(header));
+
+    uint8_t packed[BoardSnapshot::PackedSize];
+    snapshot.pack(packed);
+    out.append((const char*)packed, sizeof(packed));
+    checkboard->getStartPosition().pack(packed);
+    out.append((const char*)packed, sizeof(packed));
+
+    uint8_t count[4];
+    Bytes::storeLittle(count, (uint32_t)moves.size());
+    out.append((const char*)count, sizeof(count));
+    for (const auto& move : moves) {
+        uint8_t packedMove[Move::PackedSize];
+        move.pack(packedMove);
+        out.append((const char*)packedMove, sizeof(packedMove));
+    }
+
+    ofstream file(target, ios::binary);
+    if (!file.is_open() || !file.write(out.data(), (streamsize)out.size()).flush())
+        throw runtime_error("Couldn't write to savefile");
+}
+
+void Saver::saveText(const PChessboard& checkboard, const string& target) const
+{
+    ofstream file(target);
     if (!file.is_open()) // stream failed to read int data
         throw runtime_error("Couldn't write to savefile");
 
     file << checkboard->getWhitesTurn() << "\n";
     for (const auto& item : checkboard->getAllFigures())
         file << dumpFigure(item) << "\n";
+
+    const auto& captures = checkboard->getCaptures().getEntries();
+    file << captureLogTag << " " << checkboard->getPly() << " " << captures.size() << "\n";
+    for (const auto& i : captures)
+        file << i.ply << " " << (unsigned int)i.capturedId << " " << (unsigned int)i.capturingId
+             << " " << (unsigned int)i.square << "\n";
     file.close();
+    if (!file)
+        throw runtime_error("Couldn't write to savefile");
 }
 
 string Saver::dumpFigure(const PFigure& fig) const
@@ -53,10 +204,8 @@ string Saver::dumpFigure(const PFigure& fig) const
     stream << fig->getPlayer() << " " << fig->getType() << " " << fig->getPoint()->getX() << " "
            << fig->getPoint()->getY() << " " << fig->getMovesCount();
 
-    if (fig->isAlive())
-        stream << " " << -1;
-    else
-        stream << " " << 1 << " " << dumpFigure(fig->getKilledBy());
+    // killer is not stored here anymore, 0 marks a figure listed in the capture log
+    stream << " " << (fig->isAlive() ? -1 : 0) << " " << fig->getId();
 
     return stream.str();
 }
@@ -74,22 +223,22 @@ PFigure Saver::restoreFigure(const std::string& data) const
     player = static_cast<FigurePlayer>(i);
     stream >> i;
     type = static_cast<FigureType>(i);
-    stream >> x >> y >> moves >> i; // i indicates -1 = alive, 1 = killed by ...
+    stream >> x >> y >> moves >> i; // i indicates -1 = alive, 0 = captured, 1 = killed by ...
 
     if (!stream.eof() && stream.fail()) // stream failed to read int data
         throw runtime_error("Got bad formatted savefile");
 
-    auto figure = make_shared<Figure>(Point(x, y), type, player, moves);
+    auto figure = make_shared<Figure>(Point(x, y), type, player, moves, i != -1);
 
-    if (i == 1) {
-        string killerInfo;
-        getline(stream, killerInfo);
-        figure->isCapturedBy(restoreFigure(killerInfo));
-    }
+    // old savefiles follow with the killer's data, which is not needed anymore
+    unsigned int id = 0;
+    if (i != 1 && stream >> id)
+        figure->setId(id);
     return figure;
 }
 
-Saver::Saver(string f)
+Saver::Saver(string f, Format fmt)
     : fileName(std::move(f))
+    , format(fmt)
 {
 }
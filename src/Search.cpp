@@ -0,0 +1,148 @@
+#include <Chessboard.h>
+#include <Figure.h>
+#include <Move.h>
+#include <Point.h>
+#include <Search.h>
+#include <Tablebase.h>
+#include <TimeManager.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+namespace {
+// indexed by FigureType
+const int figureValue[] = {100, 500, 320, 330, 900, 0};
+} // namespace
+
+Search::Search(PTimeManager tm, PTablebase t)
+    : timeManager(std::move(tm))
+    , tablebase(std::move(t))
+    , nodes(0)
+    , completedDepth(0)
+    , score(0)
+{
+}
+
+Move Search::think(const PChessboard& game, unsigned int maxDepth)
+{
+    // search works on a private copy, so the game board can be shown meanwhile;
+    // a clone rather than a snapshot keeps the history for repetitions
+    const auto board = game->clone();
+    const auto side = board->getWhitesTurn() ? Whites : Blacks;
+    auto rootMoves = board->listMoves(side);
+    if (rootMoves.empty())
+        throw runtime_error("No moves to think about");
+
+    nodes = 0;
+    completedDepth = 0;
+    score = 0;
+    bestMove = rootMoves.front();
+
+    for (unsigned int depth = 1; depth <= maxDepth; ++depth) {
+        int alpha = -MateScore - 1;
+        size_t bestIndex = 0;
+        bool aborted = false;
+
+        for (size_t i = 0; i < rootMoves.size(); ++i) {
+            auto child = makeMove(board, rootMoves[i]);
+            int value = -negamax(child, depth - 1, -MateScore - 1, -alpha, 1);
+            if (timeManager->shouldStop(nodes)) {
+                aborted = true;
+                break;
+            }
+            if (value > alpha) {
+                alpha = value;
+                bestIndex = i;
+            }
+        }
+        if (aborted)
+            break;
+
+        // search best move first on the next iteration
+        rotate(rootMoves.begin(), rootMoves.begin() + bestIndex, rootMoves.begin() + bestIndex + 1);
+        bestMove = rootMoves.front();
+        score = alpha;
+        completedDepth = depth;
+
+        timeManager->iterationFinished(bestMove, score);
+        if (!timeManager->canStartIteration())
+            break;
+    }
+
+    return bestMove;
+}
+
+int Search::negamax(
+    const PChessboard& board, unsigned int depth, int alpha, int beta, unsigned int ply)
+{
+    ++nodes;
+    if (timeManager->shouldStop(nodes))
+        return 0;
+
+    // repeating a position is scored as a draw, as well as other drawn endings
+    if (board->isRepetition() || board->isFiftyMoveRule() || board->hasInsufficientMaterial())
+        return 0;
+
+    TablebaseResult result;
+    if (tablebase && tablebase->probe(*board, result)) {
+        const int mate = MateScore - (int)(ply + result.plies);
+        return result.wdl == TablebaseResult::Win ? mate
+            : result.wdl == TablebaseResult::Loss ? -mate
+                                                  : 0;
+    }
+
+    if (depth == 0)
+        return evaluate(board);
+
+    // captures come first and a cutoff spares generating the rest
+    const auto side = board->getWhitesTurn() ? Whites : Blacks;
+    bool anyMove = false;
+    for (const auto& move : board->generateMoves(side)) {
+        anyMove = true;
+        auto child = makeMove(board, move);
+        int value = -negamax(child, depth - 1, -beta, -alpha, ply + 1);
+        if (value >= beta)
+            return beta;
+        alpha = max(alpha, value);
+    }
+    if (!anyMove) // mate loses, stalemate is a draw
+        return board->isInCheck(side) ? -MateScore + (int)ply : 0;
+    return alpha;
+}
+
+int Search::evaluate(const PChessboard& board)
+{
+    int balance = 0;
+    for (const auto& i : board->getBoard())
+        balance += i->getPlayer() == Whites ? figureValue[i->getType()]
+                                            : -figureValue[i->getType()];
+    return board->getWhitesTurn() ? balance : -balance;
+}
+
+PChessboard Search::makeMove(const PChessboard& board, const Move& move)
+{
+    auto child = board->clone();
+    if (!child->prepareMove(
+            make_shared<Point>(move.getFrom()), make_shared<Point>(move.getTo()), move.getPromotion()))
+        throw runtime_error("Generated move was rejected: " + move.asString());
+    child->setTurn(!board->getWhitesTurn());
+    return child;
+}
+
+uint64_t Search::getNodes() const
+{
+    return nodes;
+}
+
+unsigned int Search::getDepth() const
+{
+    return completedDepth;
+}
+
+int Search::getScore() const
+{
+    return score;
+}
@@ -0,0 +1,436 @@
+#include <Attacks.h>
+#include <BoardSnapshot.h>
+#include <Bytes.h>
+#include <Chessboard.h>
+#include <Figure.h>
+#include <MappedFile.h>
+#include <Move.h>
+#include <Point.h>
+#include <Tablebase.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+using namespace TablebaseIndex;
+
+namespace {
+
+// file layout, numbers are little endian:
+//   header: magic, version (2), figure, reserved, position count (4), block size (4),
+//   block count (4)
+//   block offsets: block count + 1 numbers (4) counted from the start of the data
+//   data: every block is its count of distinct values - 1, the values sorted, and
+//   then BlockSize numbers of those values packed in as few bits as they need
+const char tableMagic[4] = {'C', 'H', 'S', 'T'};
+const uint16_t tableVersion = 1;
+const size_t headerSize = 20;
+
+/// values not found yet while solving, never written
+const uint8_t Unknown = 254;
+
+[[noreturn]] void badTable()
+{
+    throw runtime_error("Got bad formatted tablebase");
+}
+
+/// squares figure attacks, white pawns only as tables have figures of Whites
+Bitboard figureAttacks(FigureType figure, int square, Bitboard taken)
+{
+    switch (figure) {
+    case Queen:
+        return Attacks::rook(square, taken) | Attacks::bishop(square, taken);
+    case Rook:
+        return Attacks::rook(square, taken);
+    default:
+        return Attacks::pawn[Whites][square];
+    }
+}
+
+/// one table being solved, values of the previous pass are read and the next ones written
+struct Solver {
+    FigureType figure;
+    const uint8_t* previous;
+    /// tables of figures a pawn promotes to
+    const uint8_t* queens = nullptr;
+    const uint8_t* rooks = nullptr;
+
+    bool isValid(bool strongToMove, int strongKing, int weakKing, int square) const
+    {
+        if (strongKing == weakKing || strongKing == square || weakKing == square
+            || (Attacks::king[strongKing] & Attacks::bit(weakKing % 8, weakKing / 8)))
+            return false;
+        if (figure == Pawn && (square < 8 || square >= 56))
+            return false;
+        // the lone king cannot be in check when the other side is to move
+        return !strongToMove || !isCheck(strongKing, weakKing, square);
+    }
+
+    bool isCheck(int strongKing, int weakKing, int square) const
+    {
+        const Bitboard taken = Bitboard(1) << strongKing | Bitboard(1) << weakKing
+            | Bitboard(1) << square;
+        return figureAttacks(figure, square, taken) >> weakKing & 1;
+    }
+
+    /// calls visit with the value of every position a legal move leads to, as seen
+    /// by the opponent; captures of the figure and minor promotions are draws
+    template <typename Visit>
+    void forEachMove(bool strongToMove, int strongKing, int weakKing, int square,
+                     Visit&& visit) const
+    {
+        const Bitboard figureBit = Bitboard(1) << square;
+        if (strongToMove) {
+            for (auto targets = Attacks::king[strongKing] & ~figureBit & ~Attacks::king[weakKing];
+                 targets;)
+                visit(previous[index(false, Attacks::popLowest(targets), weakKing, square)]);
+
+            if (figure != Pawn) {
+                const Bitboard taken = Bitboard(1) << strongKing | Bitboard(1) << weakKing
+                    | figureBit;
+                for (auto targets = figureAttacks(figure, square, taken) & ~taken; targets;) {
+                    const int target = Attacks::popLowest(targets);
+                    visit(previous[index(false, strongKing, weakKing, target)]);
+                }
+                return;
+            }
+
+            const int step = square + 8;
+            if (step == strongKing || step == weakKing)
+                return;
+            if (step >= 56) {
+                visit(queens[index(false, strongKing, weakKing, step)]);
+                visit(rooks[index(false, strongKing, weakKing, step)]);
+                visit(Draw); // knight
+                visit(Draw); // bishop
+                return;
+            }
+            visit(previous[index(false, strongKing, weakKing, step)]);
+            const int jump = square + 16;
+            if (square < 16 && jump != strongKing && jump != weakKing)
+                visit(previous[index(false, strongKing, weakKing, jump)]);
+            return;
+        }
+
+        // the lone king's old square does not shield anything
+        const Bitboard attacked = Attacks::king[strongKing]
+            | figureAttacks(figure, square, Bitboard(1) << strongKing | figureBit);
+        for (auto targets = Attacks::king[weakKing] & ~Attacks::king[strongKing]; targets;) {
+            const int target = Attacks::popLowest(targets);
+            if (target == square)
+                visit(Draw); // kings alone, the figure was not defended
+            else if (!(attacked >> target & 1))
+                visit(previous[index(true, strongKing, target, square)]);
+        }
+    }
+};
+
+} // namespace
+
+TablebaseGenerator::TablebaseGenerator(unsigned int t)
+    : threads(max(t, 1u))
+{
+}
+
+const vector<uint8_t>& TablebaseGenerator::solve(FigureType figure)
+{
+    if (figure != Queen && figure != Rook && figure != Pawn)
+        throw invalid_argument("Tablebases are for a queen, a rook or a pawn");
+    const auto found = solved.find(figure);
+    if (found != solved.end())
+        return found->second;
+
+    Solver solver{figure, nullptr};
+    unsigned int longest = 0;
+    if (figure == Pawn) {
+        for (const auto promoted : {Queen, Rook})
+            for (const auto value : solve(promoted))
+                if (value != Invalid && value != Draw)
+                    longest = max(longest, (unsigned int)value - 1);
+        solver.queens = solved[Queen].data();
+        solver.rooks = solved[Rook].data();
+    }
+
+    // mates and stalemates, the rest is found pass by pass
+    vector<uint8_t> values(PositionCount, Invalid);
+    for (size_t i = 0; i < PositionCount; ++i) {
+        const bool strongToMove = i < PositionCount / 2;
+        const int strongKing = (int)(i / 4096 % 64), weakKing = (int)(i / 64 % 64),
+                  square = (int)(i % 64);
+        if (!solver.isValid(strongToMove, strongKing, weakKing, square))
+            continue;
+        bool anyMove = false;
+        solver.previous = values.data();
+        solver.forEachMove(
+            strongToMove, strongKing, weakKing, square, [&](uint8_t) { anyMove = true; });
+        if (anyMove)
+            values[i] = Unknown;
+        else if (!strongToMove && solver.isCheck(strongKing, weakKing, square))
+            values[i] = 1; // mated
+        else
+            values[i] = Draw;
+    }
+
+    // a pass for n plies only reads results of fewer plies, so threads can
+    // share it, reading the last pass and writing to a copy
+    vector<uint8_t> next = values;
+    for (unsigned int plies = 1; plies <= longest + 1; ++plies) {
+        if (plies + 1 >= Unknown)
+            throw logic_error("Tablebase mates are too long to store");
+        solver.previous = values.data();
+        atomic<unsigned int> changed{0};
+        auto work = [&](size_t begin, size_t end) {
+            unsigned int found = 0;
+            for (size_t i = begin; i < end; ++i) {
+                if (values[i] != Unknown)
+                    continue;
+                bool win = false, allLose = true;
+                unsigned int slowest = 0;
+                solver.forEachMove(i < PositionCount / 2, (int)(i / 4096 % 64),
+                                   (int)(i / 64 % 64), (int)(i % 64), [&](uint8_t value) {
+                                       if (value == Unknown || value == Draw) {
+                                           allLose = false;
+                                           return;
+                                       }
+                                       const unsigned int distance = value - 1u;
+                                       if (distance % 2 == 0) { // opponent is mated
+                                           win = win || distance + 1 == plies;
+                                           allLose = false;
+                                       } else {
+                                           slowest = max(slowest, distance);
+                                       }
+                                   });
+                if (win || (allLose && slowest + 1 == plies)) {
+                    next[i] = (uint8_t)(plies + 1);
+                    ++found;
+                }
+            }
+            changed += found;
+        };
+
+        vector<thread> workers;
+        const size_t part = (PositionCount + threads - 1) / threads;
+        for (unsigned int t = 1; t < threads; ++t)
+            workers.emplace_back(work, t * part, min(PositionCount, (t + 1) * part));
+        work(0, min(PositionCount, part));
+        for (auto& worker : workers)
+            worker.join();
+
+        values = next;
+        if (changed)
+            longest = max(longest, plies);
+    }
+
+    // nobody can force a mate from what is left
+    for (auto& value : values)
+        if (value == Unknown)
+            value = Draw;
+    return solved[figure] = std::move(values);
+}
+
+void TablebaseGenerator::write(FigureType figure, const string& fileName)
+{
+    const auto& values = solve(figure);
+    const size_t blockCount = PositionCount / Tablebase::BlockSize;
+
+    vector<uint8_t> offsets((blockCount + 1) * 4), data;
+    array<uint8_t, Tablebase::BlockSize> block;
+    for (size_t b = 0; b < blockCount; ++b) {
+        Bytes::storeLittle(offsets.data() + b * 4, (uint32_t)data.size());
+
+        // impossible positions are never probed, so they repeat whatever came
+        // before and leave fewer distinct values to number
+        const auto* value = values.data() + b * Tablebase::BlockSize;
+        uint8_t last = Draw;
+        for (size_t i = 0; i < block.size(); ++i)
+            block[i] = last = value[i] == Invalid ? last : value[i];
+
+        vector<uint8_t> palette(block.begin(), block.end());
+        sort(palette.begin(), palette.end());
+        palette.erase(unique(palette.begin(), palette.end()), palette.end());
+        unsigned int bits = 0;
+        while ((size_t(1) << bits) < palette.size())
+            ++bits;
+
+        data.push_back((uint8_t)(palette.size() - 1));
+        data.insert(data.end(), palette.begin(), palette.end());
+        const size_t packed = data.size();
+        // one spare byte, so a reader can always take two
+        data.resize(packed + (block.size() * bits + 7) / 8 + (bits ? 1 : 0));
+        for (size_t i = 0; i < block.size(); ++i) {
+            const auto number = (unsigned int)(lower_bound(palette.begin(), palette.end(), block[i])
+                                               - palette.begin());
+            for (unsigned int bit = 0; bit < bits; ++bit)
+                if (number >> bit & 1)
+                    data[packed + (i * bits + bit) / 8] |= (uint8_t)(1 << (i * bits + bit) % 8);
+        }
+    }
+    Bytes::storeLittle(offsets.data() + blockCount * 4, (uint32_t)data.size());
+
+    uint8_t header[headerSize] = {};
+    memcpy(header, tableMagic, sizeof(tableMagic));
+    Bytes::storeLittle(header + 4, tableVersion);
+    header[6] = (uint8_t)figure;
+    Bytes::storeLittle(header + 8, (uint32_t)PositionCount);
+    Bytes::storeLittle(header + 12, (uint32_t)Tablebase::BlockSize);
+    Bytes::storeLittle(header + 16, (uint32_t)blockCount);
+
+    ofstream file(fileName, ios::binary);
+    if (!file.is_open())
+        throw runtime_error("Couldn't write to " + fileName);
+    file.write((const char*)header, sizeof(header));
+    file.write((const char*)offsets.data(), (streamsize)offsets.size());
+    file.write((const char*)data.data(), (streamsize)data.size());
+    if (!file.flush())
+        throw runtime_error("Couldn't write to " + fileName);
+}
+
+string Tablebase::fileName(FigureType figure)
+{
+    static const char letters[] = "PRNBQK";
+    return string("K") + letters[figure] + "K.tbs";
+}
+
+Tablebase::Tablebase(const string& directory)
+{
+    const size_t blockCount = PositionCount / BlockSize;
+    for (const auto figure : {Queen, Rook, Pawn}) {
+        const auto path = filesystem::path(directory) / fileName(figure);
+        if (!filesystem::exists(path))
+            continue;
+
+        auto& table = tables[figure];
+        table.file = make_unique<MappedFile>(path.string());
+        const auto* data = table.file->getData();
+        const auto size = table.file->getSize();
+        if (size < headerSize + (blockCount + 1) * 4
+            || memcmp(data, tableMagic, sizeof(tableMagic)) != 0
+            || Bytes::loadLittle<uint16_t>(data + 4) != tableVersion || data[6] != figure
+            || Bytes::loadLittle<uint32_t>(data + 8) != PositionCount
+            || Bytes::loadLittle<uint32_t>(data + 12) != BlockSize
+            || Bytes::loadLittle<uint32_t>(data + 16) != blockCount)
+            badTable();
+        table.offsets = data + headerSize;
+        table.data = table.offsets + (blockCount + 1) * 4;
+        table.dataSize = size - headerSize - (blockCount + 1) * 4;
+        if (Bytes::loadLittle<uint32_t>(table.offsets + blockCount * 4) != table.dataSize)
+            badTable();
+    }
+}
+
+bool Tablebase::has(FigureType figure) const
+{
+    return figure < King && tables[figure].file;
+}
+
+uint8_t Tablebase::value(FigureType figure, size_t index) const
+{
+    if (!has(figure) || index >= PositionCount)
+        throw invalid_argument("No such tablebase position");
+    const auto& table = tables[figure];
+    const auto block = index / BlockSize;
+    const size_t begin = Bytes::loadLittle<uint32_t>(table.offsets + block * 4);
+    const size_t end = Bytes::loadLittle<uint32_t>(table.offsets + block * 4 + 4);
+    if (begin >= end || end > table.dataSize)
+        badTable();
+
+    const auto* palette = table.data + begin + 1;
+    const size_t paletteSize = table.data[begin] + 1u;
+    unsigned int bits = 0;
+    while ((size_t(1) << bits) < paletteSize)
+        ++bits;
+    if (begin + 1 + paletteSize + (bits ? (BlockSize * bits + 7) / 8 + 1 : 0) > end)
+        badTable();
+    if (!bits)
+        return palette[0];
+
+    const size_t position = index % BlockSize * bits;
+    const auto* packed = palette + paletteSize + position / 8;
+    const auto number = (Bytes::loadLittle<uint16_t>(packed) >> position % 8) & ((1u << bits) - 1);
+    if (number >= paletteSize)
+        badTable();
+    return palette[number];
+}
+
+bool Tablebase::probe(const Chessboard& board, TablebaseResult& result) const
+{
+    // counting squares is cheap enough to be done in every search node
+    auto taken = board.occupancy(Whites) | board.occupancy(Blacks);
+    int squares[3], count = 0;
+    while (taken) {
+        if (count == 3)
+            return false;
+        squares[count++] = Attacks::popLowest(taken);
+    }
+    if (count != 3)
+        return false;
+
+    int strongKing = -1, weakKing = -1, square = -1;
+    FigureType figure = King;
+    FigurePlayer strong = Whites;
+    for (const auto s : squares) {
+        const auto found = board.atSquare(s);
+        if (found->getType() != King) {
+            figure = found->getType();
+            strong = found->getPlayer();
+            square = s;
+        }
+    }
+    if (!has(figure) || board.snapshot().getCastling())
+        return false;
+    // tables are for Whites having the figure, Blacks' positions are mirrored
+    const int flip = strong == Whites ? 0 : 56;
+    for (const auto s : squares) {
+        const auto found = board.atSquare(s);
+        if (found->getType() == King)
+            (found->getPlayer() == strong ? strongKing : weakKing) = s ^ flip;
+    }
+
+    const bool strongToMove = board.getWhitesTurn() == (strong == Whites);
+    const auto stored = value(figure, index(strongToMove, strongKing, weakKing, square ^ flip));
+    if (stored == Draw) {
+        result = TablebaseResult();
+        return true;
+    }
+    result.plies = stored - 1u;
+    result.wdl = result.plies % 2 ? TablebaseResult::Win : TablebaseResult::Loss;
+    return true;
+}
+
+bool Tablebase::bestMove(const Chessboard& board, Move& move) const
+{
+    TablebaseResult result;
+    if (!probe(board, result))
+        return false;
+
+    const auto side = board.getWhitesTurn() ? Whites : Blacks;
+    const auto moves = board.listMoves(side);
+    int best = 0;
+    bool any = false;
+    for (const auto& candidate : moves) {
+        auto child = board.clone();
+        if (!child->prepareMove(make_shared<Point>(candidate.getFrom()),
+                                make_shared<Point>(candidate.getTo()), candidate.getPromotion()))
+            throw runtime_error("Generated move was rejected: " + candidate.asString());
+        child->setTurn(side != Whites);
+
+        // bare kings and minor promotions leave no table to ask, they are draws
+        TablebaseResult reply;
+        int score = 0;
+        if (probe(*child, reply) && reply.wdl != TablebaseResult::Draw)
+            score = reply.wdl == TablebaseResult::Loss ? 1000 - (int)reply.plies
+                                                        : -1000 + (int)reply.plies;
+        if (!any || score > best) {
+            best = score;
+            move = candidate;
+            any = true;
+        }
+    }
+    return any;
+}
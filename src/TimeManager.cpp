@@ -0,0 +1,114 @@
+#include <GameClock.h>
+#include <Move.h>
+#include <TimeManager.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+using namespace std::chrono;
+
+namespace {
+const milliseconds moveOverhead(50); /// rendering and input lag we never get back
+const unsigned int suddenDeathHorizon = 30; /// expected moves left when clock never refills
+} // namespace
+
+TimeManager::TimeManager()
+    : optimum(0)
+    , softLimit(0)
+    , hardLimit(0)
+    , stopFlag(false)
+    , iterations(0)
+    , stableIterations(0)
+    , lastScore(0)
+{
+}
+
+void TimeManager::start(const GameClock& gameClock, FigurePlayer side)
+{
+    auto left = max(gameClock.getRemaining(side) - moveOverhead, milliseconds(1));
+    auto movesToGo = gameClock.getMovesToGo(side);
+    movesToGo = movesToGo ? min(movesToGo, suddenDeathHorizon) : suddenDeathHorizon;
+
+    optimum = left / movesToGo + gameClock.getIncrement() * 3 / 4;
+    // never plan to burn more than a fifth of the clock on one move
+    hardLimit = min(optimum * 4, left / 5 + gameClock.getIncrement());
+    hardLimit = max(min(hardLimit, left), milliseconds(1));
+    optimum = min(optimum, hardLimit);
+
+    softLimit = optimum;
+    startTime = clock::now();
+    stopFlag.store(false, memory_order_relaxed);
+    iterations = stableIterations = 0;
+    lastScore = 0;
+}
+
+void TimeManager::start(milliseconds moveTime)
+{
+    optimum = softLimit = hardLimit = max(moveTime, milliseconds(1));
+    startTime = clock::now();
+    stopFlag.store(false, memory_order_relaxed);
+    iterations = stableIterations = 0;
+    lastScore = 0;
+}
+
+void TimeManager::iterationFinished(const Move& best, int score)
+{
+    if (iterations == 0) {
+        lastBest = best;
+        lastScore = score;
+        ++iterations;
+        return;
+    }
+
+    stableIterations = best == lastBest ? stableIterations + 1 : 0;
+
+    // best move keeps changing - think longer; same answer for a while - save time
+    double factor = stableIterations == 0 ? 1.5 : stableIterations >= 3 ? 0.6 : 0.9;
+
+    // position got worse since previous iteration, look for a rescue
+    const int drop = lastScore - score;
+    if (drop > 30)
+        factor *= 1.0 + min(drop, 300) / 300.0;
+
+    if (optimum != hardLimit)
+        softLimit = min(
+            hardLimit, milliseconds((long long)((double)optimum.count() * factor)));
+
+    lastBest = best;
+    lastScore = score;
+    ++iterations;
+}
+
+bool TimeManager::canStartIteration() const
+{
+    // next iteration usually takes longer than all previous together
+    return !stopFlag.load(memory_order_relaxed) && elapsed() * 2 < softLimit;
+}
+
+bool TimeManager::shouldStop(uint64_t nodes)
+{
+    if (nodes % PollInterval == 0 && elapsed() >= hardLimit)
+        stopFlag.store(true, memory_order_relaxed);
+    return stopFlag.load(memory_order_relaxed);
+}
+
+void TimeManager::stop()
+{
+    stopFlag.store(true, memory_order_relaxed);
+}
+
+milliseconds TimeManager::elapsed() const
+{
+    return duration_cast<milliseconds>(clock::now() - startTime);
+}
+
+milliseconds TimeManager::getSoftLimit() const
+{
+    return softLimit;
+}
+
+milliseconds TimeManager::getHardLimit() const
+{
+    return hardLimit;
+}
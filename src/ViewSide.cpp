@@ -1,14 +1,19 @@
 #include <Chessboard.h>
 #include <Figure.h>
+#include <GameClock.h>
 #include <Point.h>
+#include <PositionDb.h>
 #include <ViewSide.h>
 
 #include <algorithm>
+#include <chrono>
 #include <climits>
+#include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
 #include <set>
+#include <sstream>
 
 using namespace std;
 
@@ -19,7 +24,6 @@ void ViewSide::renderText(const string& str) const
 
 void ViewSide::renderFigures(const PChessboard& board) const
 {
-    auto point = make_shared<Point>(0, 0);
     cout << "    ";
     for (int j = 0; j < 8; j++) {
         cout << setw(6) << j;
@@ -29,9 +33,7 @@ void ViewSide::renderFigures(const PChessboard& board) const
         cout << i << "  |";
         for (int j = 0; j < 8; j++) {
             char ch = '-';
-            point->setX(j);
-            point->setY(i);
-            const auto figure = board->at(point);
+            const auto figure = board->atSquare(i * 8 + j);
             if (figure)
                 ch = figure->asChar();
             cout << setw(6) << ch;
@@ -85,11 +87,23 @@ PPoint ViewSide::getPoint(const string& message) const
     return make_shared<Point>(x, y);
 }
 
+FigureType ViewSide::askPromotion() const
+{
+    static const FigureType choices[] = {Queen, Rook, Bishop, Knight};
+    cout << "Promote pawn to: 0 - Queen, 1 - Rook, 2 - Bishop, 3 - Knight" << endl;
+    return choices[inputAction(0, 3)];
+}
+
 void ViewSide::renderKillText(char i, char i1) const
 {
     cout << i << " got killed by " << i1 << endl;
 }
 
+void ViewSide::renderDraw(const string& reason) const
+{
+    cout << "Draw by " << reason << endl;
+}
+
 void ViewSide::renderSelectedInfo(const PFigure& Figure) const
 {
     cout << "Selected " << Figure->asChar() << " of "
@@ -122,3 +136,29 @@ void ViewSide::renderFreeFigures(const set<PFigure>& set) const
     }
     cout << endl;
 }
+
+void ViewSide::renderClocks(const GameClock& clock) const
+{
+    auto format = [](chrono::milliseconds left) -> string {
+        auto seconds = max(left, chrono::milliseconds(0)).count() / 1000;
+        ostringstream s;
+        s << seconds / 60 << ":" << setw(2) << setfill('0') << seconds % 60;
+        return s.str();
+    };
+    cout << "Whites " << format(clock.getRemaining(Whites)) << " | Blacks "
+         << format(clock.getRemaining(Blacks)) << endl;
+}
+
+void ViewSide::renderPositionStats(const PositionStats& stats) const
+{
+    const auto games = stats.games();
+    if (games == 0)
+        return;
+    auto percent = [games](uint32_t count) { return (uint64_t)count * 100 / games; };
+    cout << "Played " << games << " times: Whites won " << percent(stats.whitesWon) << "%, draws "
+         << percent(stats.draws) << "%, Blacks won " << percent(stats.blacksWon) << "%" << endl;
+    const size_t shown = 5;
+    for (size_t i = 0; i < stats.moves.size() && i < shown; ++i)
+        cout << "  " << stats.moves[i].first.asString() << " (" << stats.moves[i].second << ")"
+             << endl;
+}
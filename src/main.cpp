@@ -1,24 +1,197 @@
+#include <Bench.h>
+#include <BookBuilder.h>
 #include <Game.h>
+#include <GameClock.h>
+#include <Journal.h>
+#include <PgnReader.h>
+#include <PolyglotBook.h>
+#include <PositionDb.h>
 #include <Saver.h>
+#include <Tablebase.h>
 #include <ViewSide.h>
 
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
 
 using std::make_shared;
 
-int main()
+namespace {
+
+const char* usage = "Usage: chess [minutes [increment seconds [moves to go]]]\n"
+                    "       chess bench [depth]\n"
+                    "       chess pgn file [threads]\n"
+                    "       chess positions pgn database\n"
+                    "       chess book book threads \"min games\" \"min score\"\n"
+                    "                  pgn or journal files...\n"
+                    "       chess tablebase directory [threads]";
+
+bool isNumber(const std::string& text)
+{
+    return !text.empty() && text.find_first_not_of("0123456789") == std::string::npos;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
 {
     auto view = make_shared<ViewSide>();
 
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        Bench bench(argc > 2 ? std::atoi(argv[2]) : 2);
+        bench.run(view);
+        return 0;
+    }
+
+    // chess pgn file [threads], replays every game of file and reports the speed
+    if (argc > 2 && std::string(argv[1]) == "pgn") {
+        PgnReader reader(argc > 3 ? std::atoi(argv[3]) : 1);
+        try {
+            view->renderText(reader.readFile(argv[2], [](const PgnGame&) {}).asString());
+        } catch (std::exception& e) {
+            view->renderText(e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    // chess positions file database, collects positions of every game of file
+    if (argc > 3 && std::string(argv[1]) == "positions") {
+        PositionDbBuilder builder;
+        try {
+            // one thread, builder is not meant to be shared
+            PgnReader reader;
+            auto stats = reader.readFile(argv[2], [&builder](const PgnGame& game) {
+                builder.addGame(*game.board, game.result);
+            });
+            builder.write(argv[3]);
+            view->renderText(stats.asString());
+            view->renderText("Positions collected: " + std::to_string(builder.size()));
+        } catch (std::exception& e) {
+            view->renderText(e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    // chess book file threads "min games" "min score" pgn or journal files..., builds a
+    // Polyglot book, min score is the percentage a move must score for its side
+    if (argc > 6 && std::string(argv[1]) == "book") {
+        BookBuilder builder(
+            PolyglotKeys(), std::atoi(argv[3]), std::atoi(argv[4]), std::atoi(argv[5]));
+        try {
+            builder.addFiles(std::vector<std::string>(argv + 6, argv + argc));
+            builder.write(argv[2]);
+            view->renderText(builder.getStats().asString());
+        } catch (std::exception& e) {
+            view->renderText(e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    // chess tablebase directory [threads], solves KQK, KRK and KPK
+    if (argc > 2 && std::string(argv[1]) == "tablebase") {
+        TablebaseGenerator generator(argc > 3 ? std::atoi(argv[3]) : 1);
+        try {
+            for (const auto figure : {Queen, Rook, Pawn}) {
+                const auto start = std::chrono::steady_clock::now();
+                const auto path = std::filesystem::path(argv[2]) / Tablebase::fileName(figure);
+                generator.write(figure, path.string());
+                const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start);
+                std::ostringstream line;
+                line << path.string() << ": " << std::filesystem::file_size(path) << " bytes, "
+                     << elapsed.count() << " ms";
+                view->renderText(line.str());
+            }
+        } catch (std::exception& e) {
+            view->renderText(e.what());
+            return 1;
+        }
+        return 0;
+    }
+
+    // chess [minutes [increment seconds [moves to go]]], 15 + 10 by default, anything
+    // else is a subcommand missing its arguments or a typo
+    for (int i = 1; i < argc; ++i)
+        if (i > 3 || !isNumber(argv[i])) {
+            view->renderText(usage);
+            return 1;
+        }
+    auto minutes = argc > 1 ? std::atoi(argv[1]) : 15;
+    auto increment = argc > 2 ? std::atoi(argv[2]) : 10;
+    auto movesToGo = argc > 3 ? std::atoi(argv[3]) : 0;
+    auto gameClock = make_shared<GameClock>(
+        std::chrono::minutes(minutes), std::chrono::seconds(increment), movesToGo);
+
     auto saver = make_shared<Saver>("./saveFile.txt");
-    Game game(view, saver);
+    // every move lands here and the file is removed once the game ends, so one left over
+    // is a crashed game. The new game truncates it, so it replaces an older savefile
+    // first: Saver reads journals too, Load brings the crashed game back
+    auto journal = make_shared<Journal>("./saveFile.journal");
+    try {
+        if (std::filesystem::exists("./saveFile.journal")
+            && (!std::filesystem::exists("./saveFile.txt")
+                || std::filesystem::last_write_time("./saveFile.journal")
+                    > std::filesystem::last_write_time("./saveFile.txt"))) {
+            std::filesystem::rename("./saveFile.journal", "./saveFile.txt");
+            view->renderText("The last game crashed, Load to resume it");
+        }
+    } catch (std::exception& e) {
+        view->renderText(e.what());
+    }
+    // built with "chess positions", the game goes on without statistics if it is missing
+    PPositionDb positionDb;
+    if (std::filesystem::exists("./positions.db")) {
+        try {
+            positionDb = make_shared<PositionDb>("./positions.db");
+        } catch (std::exception& e) {
+            view->renderText(e.what());
+        }
+    }
+    // built with "chess book" or any other Polyglot book, both use the Random64 table
+    PPolyglotBook book;
+    if (std::filesystem::exists("./book.bin")) {
+        try {
+            book = make_shared<PolyglotBook>("./book.bin", PolyglotKeys());
+        } catch (std::exception& e) {
+            view->renderText(e.what());
+        }
+    }
+    // tables of "chess tablebase ." are probed by the engine
+    PTablebase tablebase;
+    try {
+        tablebase = make_shared<Tablebase>(".");
+        if (!tablebase->has(Queen) && !tablebase->has(Rook) && !tablebase->has(Pawn))
+            tablebase = nullptr;
+    } catch (std::exception& e) {
+        view->renderText(e.what());
+    }
+    Game game(view, saver, gameClock, journal, "./games.pgn", positionDb, book, tablebase);
 
-    bool whiteWon = game.run();
-    if (whiteWon) {
+    switch (game.run()) {
+    case WhitesWon:
         view->renderText("Whites won, congratulations!");
-    } else {
+        break;
+    case BlacksWon:
         view->renderText("Blacks won, congratulations!");
+        break;
+    case Draw:
+        view->renderText("Nobody won this time");
+        break;
     }
+    if (book)
+        view->renderText("Book moves played: " + std::to_string(game.getBookHits()));
+    // nothing to recover from a game that ended
+    std::error_code error;
+    std::filesystem::remove("./saveFile.journal", error);
 
     return 0;
 }
@@ -0,0 +1,58 @@
+#include <BackgroundSaver.h>
+#include <Chessboard.h>
+#include <Point.h>
+#include <Saver.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "testHelpers.h"
+
+using namespace std;
+
+TEST(ChessboardBackgroundSave, WritesLatestBoard)
+{
+    const string fileName = "backgroundSaveTest.bin";
+    auto saver = make_shared<Saver>(fileName, Saver::Binary);
+    Chessboard c;
+    c.initialize();
+    {
+        BackgroundSaver background(saver);
+        const int moves[][4] = {{4, 1, 4, 3}, {4, 6, 4, 4}, {6, 0, 5, 2}, {1, 7, 2, 5}};
+        for (const auto& m : moves) {
+            play(c, m[0], m[1], m[2], m[3]);
+            background.save(c);
+        }
+        background.flush();
+
+        // back-to-back saves may be merged, but each written one is reported
+        const auto reports = background.takeReports();
+        ASSERT_FALSE(reports.empty());
+        ASSERT_LE(reports.size(), 4);
+        for (const auto& report : reports)
+            ASSERT_EQ(report, "Game saved");
+        ASSERT_TRUE(background.takeReports().empty());
+    }
+
+    auto loaded = saver->loadCheckboard();
+    ASSERT_EQ(loaded->toFen(), c.toFen());
+    ASSERT_EQ(loaded->getMoves(), c.getMoves());
+    ASSERT_FALSE(ifstream(fileName + ".tmp").is_open());
+    remove(fileName.c_str());
+}
+
+TEST(ChessboardBackgroundSave, ReportsErrors)
+{
+    Chessboard c;
+    c.initialize();
+    BackgroundSaver background(make_shared<Saver>("no/such/directory/save.txt"));
+    background.save(c);
+    background.flush();
+
+    const auto reports = background.takeReports();
+    ASSERT_EQ(reports.size(), 1);
+    ASSERT_EQ(reports.front().rfind("Couldn't save the game", 0), 0);
+}
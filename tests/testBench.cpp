@@ -0,0 +1,32 @@
+
+#include <Bench.h>
+#include <Chessboard.h>
+#include <gtest/gtest.h>
+
+TEST(Bench, StartPositionPerft)
+{
+    auto board = Bench::loadPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+
+    ASSERT_EQ(Bench::perft(board, 1), 20);
+    ASSERT_EQ(Bench::perft(board, 2), 400);
+}
+
+TEST(Bench, LoadPositionKeepsCastlingRights)
+{
+    auto board = Bench::loadPosition("r3k3/8/8/8/8/8/8/4K2R b Kq - 0 1");
+
+    ASSERT_FALSE(board->getWhitesTurn());
+    ASSERT_TRUE(board->at(std::make_shared<Point>(7, 0))->isReadyForCastling());
+    ASSERT_TRUE(board->at(std::make_shared<Point>(4, 0))->isReadyForCastling());
+    ASSERT_TRUE(board->at(std::make_shared<Point>(0, 7))->isReadyForCastling());
+    ASSERT_TRUE(board->at(std::make_shared<Point>(4, 7))->isReadyForCastling());
+}
+
+TEST(Bench, LoadPositionDropsLostCastlingRights)
+{
+    auto board = Bench::loadPosition("r3k2r/8/8/8/8/8/8/R3K2R w - - 0 1");
+
+    ASSERT_FALSE(board->at(std::make_shared<Point>(0, 0))->isReadyForCastling());
+    ASSERT_FALSE(board->at(std::make_shared<Point>(4, 0))->isReadyForCastling());
+    ASSERT_FALSE(board->at(std::make_shared<Point>(7, 7))->isReadyForCastling());
+}
@@ -0,0 +1,93 @@
+#include <Bench.h>
+#include <BookBuilder.h>
+#include <Chessboard.h>
+#include <Journal.h>
+#include <Move.h>
+#include <Point.h>
+#include <PolyglotBook.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "testGames.h"
+
+TEST(BookBuilder, BuildsBookFromPgnAndJournals)
+{
+    const std::string pgnName = "bookBuilderTest.pgn";
+    std::ofstream(pgnName) << operaGame << "[Result \"1/2-1/2\"]\n\n1. e4 e5 2. Nf3 1/2-1/2\n";
+
+    // an unfinished game, its checkpoints must not cut the opening off
+    const std::string journalName = "bookBuilderTest.journal";
+    {
+        Journal journal(journalName, 2);
+        Chessboard board;
+        board.initialize();
+        journal.start(board);
+        const int moves[][4] = {{3, 1, 3, 3}, {3, 6, 3, 4}, {2, 1, 2, 3}, {4, 6, 4, 5}};
+        for (const auto& m : moves) {
+            ASSERT_TRUE(board.prepareMove(std::make_shared<Point>(m[0], m[1]),
+                                          std::make_shared<Point>(m[2], m[3])));
+            board.setTurn(!board.getWhitesTurn());
+            journal.append(board);
+        }
+    }
+
+    Chessboard start;
+    start.initialize();
+    const std::string bookName = "bookBuilderTest.bin";
+    const PolyglotKeys keys;
+    {
+        BookBuilder builder(keys, 2);
+        builder.addFiles({pgnName, journalName});
+        builder.write(bookName);
+        const auto stats = builder.getStats();
+        ASSERT_EQ(stats.games, 3);
+        ASSERT_EQ(stats.skipped, 0);
+        ASSERT_EQ(stats.pruned, 0);
+        // 33 opera plies, 4 of the journal, the draw repeats the opera game
+        ASSERT_EQ(stats.entries, 37);
+
+        PolyglotBook book(bookName, keys);
+        ASSERT_EQ(book.size(), 37);
+        const auto found = book.find(start);
+        ASSERT_EQ(found.size(), 2);
+        // a win and a draw against an unknown result, which counts as a draw
+        ASSERT_EQ(found[0].move, Move(Point(4, 1), Point(4, 3)));
+        ASSERT_EQ(found[0].weight, 3);
+        ASSERT_EQ(found[1].move, Move(Point(3, 1), Point(3, 3)));
+        ASSERT_EQ(found[1].weight, 1);
+
+        // Blacks lost the opera game, so their replies score nothing
+        auto afterE4
+            = Bench::loadPosition("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+        ASSERT_EQ(book.find(*afterE4).at(0).weight, 1);
+    }
+    {
+        BookBuilder builder(keys, 1, 2, 0, 2);
+        builder.addFiles({pgnName, journalName});
+        builder.write(bookName);
+        ASSERT_EQ(builder.getStats().entries, 2);
+        // 1. d4 and 1... d5 were played once
+        ASSERT_EQ(builder.getStats().pruned, 2);
+
+        Move move;
+        ASSERT_TRUE(PolyglotBook(bookName, keys, PolyglotBook::Best).pick(start, move));
+        ASSERT_EQ(move, Move(Point(4, 1), Point(4, 3)));
+    }
+    {
+        // Blacks scored a quarter at best after 1. e4
+        BookBuilder builder(keys, 1, 1, 30, 2);
+        builder.addFiles({pgnName});
+        builder.write(bookName);
+        ASSERT_EQ(builder.getStats().entries, 1);
+    }
+    ASSERT_THROW(BookBuilder().addFiles({"missingBookBuilderTest.pgn"}), std::runtime_error);
+
+    std::remove(pgnName.c_str());
+    std::remove(journalName.c_str());
+    std::remove(bookName.c_str());
+}
@@ -1,11 +1,26 @@
 
 
+#include <Attacks.h>
+#include <Bench.h>
+#include <BoardSnapshot.h>
 #include <Chessboard.h>
 #include <Figure.h>
 #include <FigureFactory.h>
+#include <Move.h>
+#include <PathSystem.h>
 #include <Point.h>
+#include <Saver.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "testHelpers.h"
+
 using namespace std;
 
 typedef PFigure fig;
@@ -187,8 +202,8 @@ public:
         deadQueen = make_shared<Figure>(Point(1, 1), Queen, allySide);
         deadRook = make_shared<Figure>(Point(1, 2), Rook, allySide);
 
-        deadQueen->isCapturedBy(pawn);
-        deadRook->isCapturedBy(pawn);
+        deadQueen->capture();
+        deadRook->capture();
     }
 };
 
@@ -210,7 +225,7 @@ TEST_F(PawnReachesEndOfBoard, GetQueenIfQueenAndRookAreDead)
     ASSERT_TRUE(c.prepareMove(pawn->getPoint(), destinationPoint));
 
     ASSERT_FALSE(pawn->isAlive());
-    ASSERT_EQ(*pawn->getKilledBy(), *deadQueen);
+    ASSERT_EQ(c.getCaptures().findCaptured(pawn->getId())->capturingId, deadQueen->getId());
     ASSERT_TRUE(deadQueen->isAlive());
     ASSERT_FALSE(deadRook->isAlive());
     ASSERT_EQ(*deadQueen->getPoint(), *destinationPoint);
@@ -263,3 +278,557 @@ TEST(PawnReachesTheEnd, AndCapturesEnemy)
     ASSERT_TRUE(newCreature->isQueen());
     ASSERT_EQ(newCreature->getPlayer(), allySide);
 }
+
+TEST(ChessboardIsLegal, PinnedFigureCannotLeaveLine)
+{
+    Chessboard c;
+    c.addFigure(make_shared<Figure>(Point(4, 0), King, Whites, 1));
+    c.addFigure(make_shared<Figure>(Point(4, 1), Rook, Whites, 1));
+    c.addFigure(make_shared<Figure>(Point(4, 7), Queen, Blacks));
+    c.addFigure(make_shared<Figure>(Point(0, 7), King, Blacks, 1));
+
+    ASSERT_FALSE(c.isLegal(Move(Point(4, 1), Point(0, 1))));
+    ASSERT_TRUE(c.isLegal(Move(Point(4, 1), Point(4, 5))));
+    ASSERT_TRUE(c.isLegal(Move(Point(4, 1), Point(4, 7))));
+}
+
+TEST(ChessboardIsLegal, KingCannotStepIntoCheck)
+{
+    Chessboard c;
+    c.addFigure(make_shared<Figure>(Point(4, 0), King, Whites, 1));
+    c.addFigure(make_shared<Figure>(Point(3, 7), Rook, Blacks));
+    c.addFigure(make_shared<Figure>(Point(0, 7), King, Blacks, 1));
+
+    ASSERT_FALSE(c.isLegal(Move(Point(4, 0), Point(3, 0))));
+    ASSERT_FALSE(c.isLegal(Move(Point(4, 0), Point(3, 1))));
+    ASSERT_TRUE(c.isLegal(Move(Point(4, 0), Point(5, 1))));
+    ASSERT_FALSE(c.isLegal(Move(Point(4, 0), Point(4, 2)))); // not on the king's path
+    ASSERT_FALSE(c.isLegal(Move(Point(4, 4), Point(4, 5)))); // nobody there
+}
+
+TEST(ChessboardIsLegal, AgreesWithListOfMoves)
+{
+    auto board = Bench::loadPosition(
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+    for (auto side : {Whites, Blacks}) {
+        auto moves = board->canMoveFrom(side);
+        size_t legal = 0;
+        for (const auto& figure : board->getBoard()) {
+            if (figure->getPlayer() != side)
+                continue;
+            for (unsigned int x = 0; x < 8; ++x)
+                for (unsigned int y = 0; y < 8; ++y)
+                    if (board->isLegal(Move(*figure->getPoint(), Point(x, y))))
+                        ++legal;
+        }
+        ASSERT_EQ(legal, moves.size());
+    }
+}
+
+TEST(ChessboardMoveCache, PathComesFromLegalMoves)
+{
+    Chessboard c;
+    c.initialize();
+
+    ASSERT_EQ(c.canMoveFrom(Whites).size(), 20);
+    ASSERT_EQ(c.getPath(make_shared<Point>(1, 0)).size(), 2); // knight
+    ASSERT_TRUE(c.getPath(make_shared<Point>(5, 0)).empty()); // bishop is locked
+    ASSERT_TRUE(c.getPath(make_shared<Point>(4, 4)).empty()); // nobody there
+}
+
+TEST(ChessboardMoveCache, InvalidatedByMoveAndReinitialization)
+{
+    Chessboard c;
+    c.initialize();
+    ASSERT_EQ(c.canMoveFrom(Whites).size(), 20);
+
+    ASSERT_TRUE(c.prepareMove(make_shared<Point>(4, 1), make_shared<Point>(4, 3)));
+    ASSERT_EQ(c.getPath(make_shared<Point>(5, 0)).size(), 5); // bishop is free now
+    ASSERT_EQ(c.canMoveFrom(Whites).size(), 30);
+
+    c.initialize();
+    const auto& moves = c.canMoveFrom(Whites);
+    ASSERT_EQ(moves.size(), 20);
+    for (const auto& i : moves)
+        ASSERT_EQ(c.at(i.first->getPoint()), i.first);
+}
+
+TEST(ChessboardFigureIds, UniqueAndStableAcrossMoves)
+{
+    Chessboard c;
+    c.initialize();
+
+    set<unsigned int> ids;
+    for (const auto& figure : c.getBoard()) {
+        ASSERT_LT(figure->getId(), Chessboard::MaxFigures);
+        ASSERT_EQ(c.getFigure(figure->getId()), figure);
+        ids.insert(figure->getId());
+    }
+    ASSERT_EQ(ids.size(), 32);
+
+    auto pawn = c.at(make_shared<Point>(4, 1));
+    const auto id = pawn->getId();
+    ASSERT_EQ(c.getSquare(id), 12);
+
+    ASSERT_TRUE(c.prepareMove(make_shared<Point>(4, 1), make_shared<Point>(4, 3)));
+    ASSERT_EQ(pawn->getId(), id);
+    ASSERT_EQ(c.getSquare(id), 28);
+    ASSERT_EQ(c.atSquare(28), pawn);
+    ASSERT_EQ(c.atSquare(12), nullptr);
+}
+
+TEST(ChessboardFigureIds, CapturedFigureLeavesSquareIndex)
+{
+    auto board = Bench::loadPosition("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1");
+    auto victim = board->at(make_shared<Point>(3, 4));
+    auto hunter = board->at(make_shared<Point>(4, 3));
+
+    ASSERT_TRUE(board->prepareMove(make_shared<Point>(4, 3), make_shared<Point>(3, 4)));
+    ASSERT_EQ(board->atSquare(Attacks::square(3, 4)), hunter);
+    ASSERT_EQ(board->getSquare(victim->getId()), -1);
+    ASSERT_EQ(board->getFigure(victim->getId()), victim);
+}
+
+TEST(ChessboardFigureIds, CloneKeepsIds)
+{
+    Chessboard c;
+    c.initialize();
+    auto copy = c.clone();
+
+    for (const auto& figure : c.getBoard()) {
+        auto twin = copy->getFigure(figure->getId());
+        ASSERT_NE(twin, figure);
+        ASSERT_EQ(*twin->getPoint(), *figure->getPoint());
+        ASSERT_EQ(twin->getType(), figure->getType());
+    }
+}
+
+TEST(ChessboardCaptureLog, RecordsCapturesAndDerivesDeadFigures)
+{
+    auto board = Bench::loadPosition("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1");
+    auto victim = board->at(make_shared<Point>(3, 4));
+    auto hunter = board->at(make_shared<Point>(4, 3));
+    ASSERT_TRUE(board->getDeadFigures().empty());
+
+    ASSERT_TRUE(board->prepareMove(make_shared<Point>(4, 3), make_shared<Point>(3, 4)));
+
+    const auto& entries = board->getCaptures().getEntries();
+    ASSERT_EQ(entries.size(), 1);
+    ASSERT_EQ(entries[0].ply, 0);
+    ASSERT_EQ(entries[0].capturedId, victim->getId());
+    ASSERT_EQ(entries[0].capturingId, hunter->getId());
+    ASSERT_EQ(entries[0].square, Attacks::square(3, 4));
+    ASSERT_EQ(board->getPly(), 1);
+    ASSERT_EQ(board->getDeadFigures(), PFigures{victim});
+}
+
+TEST(ChessboardCaptureLog, RevivedFigureIsNotDead)
+{
+    Chessboard c;
+    c.addFigure(FigureFactory::buildKing(Whites));
+    c.addFigure(FigureFactory::buildKing(Blacks));
+    auto pawn = make_shared<Figure>(Point(2, 6), Pawn, Whites);
+    auto rook = make_shared<Figure>(Point(0, 0), Rook, Whites);
+    c.addFigure(pawn);
+    c.addDeadFigure(rook);
+    ASSERT_EQ(c.getDeadFigures(), PFigures{rook});
+
+    ASSERT_TRUE(c.prepareMove(pawn->getPoint(), make_shared<Point>(2, 7), Rook));
+    ASSERT_TRUE(rook->isAlive());
+    ASSERT_EQ(c.getDeadFigures(), PFigures{pawn});
+    ASSERT_EQ(c.getCaptures().size(), 2);
+}
+
+TEST(ChessboardCaptureLog, SurvivesSaveAndLoad)
+{
+    auto board = Bench::loadPosition("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1");
+    ASSERT_TRUE(board->prepareMove(make_shared<Point>(4, 3), make_shared<Point>(3, 4)));
+
+    const string fileName = "captureLogTest.txt";
+    Saver saver(fileName);
+    saver.saveCheckboard(board);
+    auto loaded = saver.loadCheckboard();
+    remove(fileName.c_str());
+
+    ASSERT_EQ(loaded->getPly(), 1);
+    ASSERT_EQ(loaded->getBoard().size(), 3);
+    ASSERT_EQ(loaded->getDeadFigures().size(), 1);
+    const auto& entries = loaded->getCaptures().getEntries();
+    ASSERT_EQ(entries.size(), 1);
+    ASSERT_EQ(entries[0].capturingId, loaded->at(make_shared<Point>(3, 4))->getId());
+    ASSERT_TRUE(loaded->getDeadFigures().front()->isPawn());
+}
+
+TEST(ChessboardCaptureLog, LoadsSavefileWithInlineKillers)
+{
+    const string fileName = "oldCaptureTest.txt";
+    {
+        ofstream file(fileName);
+        file << "1\n";
+        file << "0 5 4 0 0 -1\n";
+        file << "1 5 4 7 0 -1\n";
+        file << "1 1 0 7 1 1 0 4 0 0 3 1 1 4 6 0 -1\n"; // rook killed by a killed queen
+    }
+    auto loaded = Saver(fileName).loadCheckboard();
+    remove(fileName.c_str());
+
+    ASSERT_EQ(loaded->getBoard().size(), 2);
+    ASSERT_EQ(loaded->getAllFigures().size(), 3);
+    ASSERT_EQ(loaded->getCaptures().getEntries().front().capturingId, CaptureLog::Nobody);
+}
+
+TEST(ChessboardConcurrentReaders, ShareOnePosition)
+{
+    auto board = Bench::loadPosition(
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    auto reference = board->clone();
+    const auto whites = reference->canMoveFrom(Whites).size();
+    const auto blacks = reference->canMoveFrom(Blacks).size();
+    const auto figures = board->getAllFigures();
+
+    vector<size_t> seen(8);
+    vector<thread> readers;
+    for (size_t i = 0; i < seen.size(); ++i)
+        readers.emplace_back([&, i] {
+            for (int round = 0; round < 20; ++round) {
+                seen[i] += board->canMoveFrom(i % 2 ? Blacks : Whites).size();
+                seen[i] += board->getPath(make_shared<Point>(4, 0)).size();
+                seen[i] += board->isLegal(Move(Point(4, 0), Point(6, 0)));
+            }
+        });
+    for (auto& reader : readers)
+        reader.join();
+
+    const auto kingMoves = reference->getPath(make_shared<Point>(4, 0)).size();
+    for (size_t i = 0; i < seen.size(); ++i)
+        ASSERT_EQ(seen[i], 20 * ((i % 2 ? blacks : whites) + kingMoves + 1));
+
+    // nobody was moved or captured while generating moves
+    for (const auto& figure : figures)
+        ASSERT_TRUE(figure->isAlive());
+    ASSERT_EQ(board->getAllFigures().size(), figures.size());
+}
+
+TEST(PathSystemMoves, DoNotTouchFigures)
+{
+    auto board = Bench::loadPosition("4k3/8/8/3p4/4P3/8/8/4K3 w - - 0 1");
+    vector<Point> before;
+    for (const auto& figure : board->getBoard())
+        before.push_back(*figure->getPoint());
+
+    PathSystem paths(board->getBoard());
+    ASSERT_EQ(paths.getListOfAvailableMoves(Whites).size(), 7);
+
+    size_t i = 0;
+    for (const auto& figure : board->getBoard()) {
+        ASSERT_EQ(*figure->getPoint(), before[i++]);
+        ASSERT_TRUE(figure->isAlive());
+    }
+}
+
+TEST(ChessboardSnapshot, IsCompactAndKeepsPosition)
+{
+    ASSERT_LT(sizeof(BoardSnapshot), 128);
+
+    auto board = Bench::loadPosition("r3k2r/8/8/8/8/8/8/1R2K2R b Kkq - 0 1");
+    auto snapshot = board->snapshot();
+    ASSERT_FALSE(snapshot.getWhitesTurn());
+    ASSERT_EQ(snapshot.getCastling(),
+              BoardSnapshot::WhitesKingSide | BoardSnapshot::BlacksKingSide
+                  | BoardSnapshot::BlacksQueenSide);
+    ASSERT_EQ(snapshot.get(Attacks::square(1, 0)), BoardSnapshot::code(Rook, Whites));
+    ASSERT_EQ(snapshot.get(Attacks::square(4, 7)), BoardSnapshot::code(King, Blacks));
+    ASSERT_TRUE(snapshot.isEmpty(Attacks::square(4, 4)));
+
+    Chessboard restored(snapshot);
+    ASSERT_EQ(restored.snapshot(), snapshot);
+    ASSERT_EQ(Bench::perft(make_shared<Chessboard>(snapshot), 2), Bench::perft(board, 2));
+}
+
+TEST(ChessboardSnapshot, RestoreKeepsDeadFiguresForPromotion)
+{
+    Chessboard c;
+    c.addFigure(FigureFactory::buildKing(Blacks));
+    c.addFigure(FigureFactory::buildKing(Whites));
+    c.addFigure(make_shared<Figure>(Point(2, 1), Pawn, Blacks, 1));
+    c.addDeadFigure(make_shared<Figure>(Point(1, 2), Rook, Blacks));
+    c.setTurn(false);
+
+    Chessboard restored(c.snapshot());
+    ASSERT_EQ(restored.getDeadFigures().size(), 1);
+    ASSERT_TRUE(restored.prepareMove(make_shared<Point>(2, 1), make_shared<Point>(2, 0), Rook));
+    ASSERT_TRUE(restored.at(make_shared<Point>(2, 0))->isRook());
+    ASSERT_TRUE(restored.getDeadFigures().front()->isPawn());
+}
+
+TEST(ChessboardSnapshot, CopiesAreIndependent)
+{
+    Chessboard c;
+    c.initialize();
+    const auto start = c.snapshot();
+
+    // a copy travels to another thread and is played there
+    BoardSnapshot played;
+    thread([start, &played] {
+        Chessboard board(start);
+        board.prepareMove(make_shared<Point>(4, 1), make_shared<Point>(4, 3));
+        played = board.snapshot();
+    }).join();
+
+    ASSERT_EQ(c.snapshot(), start);
+    ASSERT_NE(played, start);
+    ASSERT_EQ(played.getPly(), 1);
+    ASSERT_EQ(played.get(Attacks::square(4, 3)), BoardSnapshot::code(Pawn, Whites));
+}
+
+TEST(ChessboardRepetition, KnightsDancingThreeTimes)
+{
+    Chessboard c;
+    c.initialize();
+    const auto start = c.getHash();
+
+    for (int round = 0; round < 2; ++round) {
+        ASSERT_EQ(c.repetitions(), (unsigned int)round);
+        play(c, 6, 0, 5, 2);
+        play(c, 6, 7, 5, 5);
+        ASSERT_NE(c.getHash(), start);
+        play(c, 5, 2, 6, 0);
+        play(c, 5, 5, 6, 7);
+        ASSERT_EQ(c.getHash(), start);
+        ASSERT_TRUE(c.isRepetition());
+    }
+    ASSERT_TRUE(c.isThreefoldRepetition());
+}
+
+TEST(ChessboardRepetition, SideToMoveMatters)
+{
+    Chessboard c;
+    c.initialize();
+    const auto whites = c.getHash();
+    c.setTurn(false);
+    ASSERT_NE(c.getHash(), whites);
+
+    // same figures, but another side to move, is no repetition
+    play(c, 6, 7, 5, 5);
+    ASSERT_FALSE(c.isRepetition());
+    play(c, 6, 0, 5, 2);
+    ASSERT_FALSE(c.isRepetition());
+    play(c, 5, 5, 6, 7);
+    ASSERT_FALSE(c.isRepetition());
+    play(c, 5, 2, 6, 0);
+    ASSERT_TRUE(c.isRepetition());
+}
+
+TEST(ChessboardRepetition, PawnMoveForgetsHistory)
+{
+    Chessboard c;
+    c.initialize();
+    play(c, 6, 0, 5, 2);
+    play(c, 6, 7, 5, 5);
+    play(c, 5, 2, 6, 0);
+    play(c, 5, 5, 6, 7);
+    ASSERT_TRUE(c.isRepetition());
+
+    play(c, 4, 1, 4, 3);
+    play(c, 6, 7, 5, 5);
+    play(c, 6, 0, 5, 2);
+    play(c, 5, 5, 6, 7);
+    play(c, 5, 2, 6, 0);
+    ASSERT_EQ(c.repetitions(), 1);
+
+    auto copy = c.clone();
+    ASSERT_EQ(copy->getHash(), c.getHash());
+    ASSERT_EQ(copy->repetitions(), 1);
+}
+
+TEST(ChessboardDraws, HalfmoveClockAndFiftyMoveRule)
+{
+    auto board = Bench::loadPosition("4k3/8/8/8/8/8/4P3/R3K3 w - - 0 1");
+    ASSERT_EQ(board->getHalfmoveClock(), 0);
+
+    // rooks walk around until fifty moves pass without pawn moves and captures
+    unsigned int x = 0;
+    for (int i = 0; i < 100; ++i) {
+        if (board->getWhitesTurn()) {
+            const unsigned int to = x == 0 ? 1 : 0;
+            play(*board, x, 0, to, 0);
+            x = to;
+        } else {
+            const unsigned int kingX = i % 4 == 1 ? 4 : 3;
+            play(*board, kingX, 7, kingX == 4 ? 3 : 4, 7);
+        }
+        ASSERT_EQ(board->getHalfmoveClock(), (unsigned int)i + 1);
+    }
+    ASSERT_TRUE(board->isFiftyMoveRule());
+    ASSERT_EQ(Chessboard(board->snapshot()).getHalfmoveClock(), 100);
+
+    play(*board, 4, 1, 4, 3);
+    ASSERT_EQ(board->getHalfmoveClock(), 0);
+    ASSERT_FALSE(board->isFiftyMoveRule());
+}
+
+TEST(ChessboardDraws, InsufficientMaterial)
+{
+    ASSERT_TRUE(Bench::loadPosition("4k3/8/8/8/8/8/8/4K3 w - - 0 1")->hasInsufficientMaterial());
+    ASSERT_TRUE(Bench::loadPosition("4k3/8/8/8/8/8/8/2B1K3 w - - 0 1")->hasInsufficientMaterial());
+    ASSERT_TRUE(Bench::loadPosition("4k1n1/8/8/8/8/8/8/4K3 w - - 0 1")->hasInsufficientMaterial());
+    ASSERT_FALSE(Bench::loadPosition("4k1n1/8/8/8/8/8/8/2B1K3 w - - 0 1")->hasInsufficientMaterial());
+    ASSERT_FALSE(Bench::loadPosition("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1")->hasInsufficientMaterial());
+
+    // capturing the last rook leaves bare kings
+    auto board = Bench::loadPosition("4k3/8/8/8/8/8/3r4/4K3 w - - 0 1");
+    ASSERT_EQ(board->getFigureCount(Blacks, Rook), 1);
+    ASSERT_FALSE(board->hasInsufficientMaterial());
+    play(*board, 4, 0, 3, 1);
+    ASSERT_EQ(board->getFigureCount(Blacks, Rook), 0);
+    ASSERT_TRUE(board->hasInsufficientMaterial());
+    ASSERT_EQ(board->getHalfmoveClock(), 0);
+}
+
+TEST(ChessboardDraws, PromotionKeepsCounts)
+{
+    auto board = Bench::loadPosition("8/P3k3/8/8/8/8/8/4K3 w - - 0 1");
+    play(*board, 0, 6, 0, 7);
+    ASSERT_EQ(board->getFigureCount(Whites, Pawn), 0);
+    ASSERT_EQ(board->getFigureCount(Whites, Queen), 1);
+    ASSERT_FALSE(board->onePlayerLeft());
+}
+
+TEST(ChessboardDraws, StalemateIsNotCheck)
+{
+    auto stalemate = Bench::loadPosition("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    ASSERT_TRUE(stalemate->canMoveFrom(Blacks).empty());
+    ASSERT_FALSE(stalemate->isInCheck(Blacks));
+
+    auto mate = Bench::loadPosition("7k/6Q1/6K1/8/8/8/8/8 b - - 0 1");
+    ASSERT_TRUE(mate->canMoveFrom(Blacks).empty());
+    ASSERT_TRUE(mate->isInCheck(Blacks));
+}
+
+TEST(ChessboardSpecialMoves, EnPassantCapturesPawnBehind)
+{
+    auto board = Bench::loadPosition("4k3/3p4/8/4P3/8/8/8/4K3 b - - 0 1");
+    play(*board, 3, 6, 3, 4);
+    ASSERT_EQ(board->getEnPassant(), Attacks::square(3, 5));
+
+    auto victim = board->at(make_shared<Point>(3, 4));
+    play(*board, 4, 4, 3, 5);
+    ASSERT_FALSE(victim->isAlive());
+    ASSERT_EQ(board->at(make_shared<Point>(3, 4)), nullptr);
+    ASSERT_EQ(board->getFigureCount(Blacks, Pawn), 0);
+    ASSERT_EQ(board->getEnPassant(), -1);
+}
+
+TEST(ChessboardSpecialMoves, EnPassantExpiresAfterOnePly)
+{
+    auto board = Bench::loadPosition("4k3/3p4/8/4P3/8/8/8/4K3 b - - 0 1");
+    play(*board, 3, 6, 3, 4);
+    play(*board, 4, 0, 5, 0);
+    play(*board, 4, 7, 5, 7);
+    ASSERT_FALSE(board->isLegal(Move(Point(4, 4), Point(3, 5))));
+}
+
+TEST(ChessboardSpecialMoves, EnPassantTakesCheckingPawn)
+{
+    auto white = Bench::loadPosition("8/8/8/4pP2/3K4/8/8/7k w - e6 0 1");
+    const auto whiteMoves = white->listMoves(Whites);
+    ASSERT_NE(find(whiteMoves.begin(), whiteMoves.end(), Move(Point(5, 4), Point(4, 5))),
+              whiteMoves.end());
+    ASSERT_EQ(whiteMoves.size(), 9u);
+
+    auto black = Bench::loadPosition("8/8/8/3k4/4Pp2/8/8/K7 b - e3 0 1");
+    const auto blackMoves = black->listMoves(Blacks);
+    ASSERT_NE(find(blackMoves.begin(), blackMoves.end(), Move(Point(5, 3), Point(4, 2))),
+              blackMoves.end());
+    ASSERT_EQ(blackMoves.size(), 9u);
+}
+
+TEST(ChessboardSpecialMoves, PromotionToChosenFigure)
+{
+    auto board = Bench::loadPosition("8/P3k3/8/8/8/8/8/4K3 w - - 0 1");
+    ASSERT_TRUE(board->isPromotion(Move(Point(0, 6), Point(0, 7))));
+    ASSERT_EQ(board->listMoves(Whites).size(), 5 + 4);
+
+    ASSERT_TRUE(board->prepareMove(make_shared<Point>(0, 6), make_shared<Point>(0, 7), Knight));
+    ASSERT_TRUE(board->at(make_shared<Point>(0, 7))->isKnight());
+    ASSERT_THROW(board->prepareMove(make_shared<Point>(4, 0), make_shared<Point>(4, 1), King),
+                 invalid_argument);
+}
+
+TEST(ChessboardSpecialMoves, DoubleStepCannotCapture)
+{
+    auto board = Bench::loadPosition("4k3/8/8/8/4p3/8/4P3/4K3 w - - 0 1");
+    ASSERT_TRUE(board->isLegal(Move(Point(4, 1), Point(4, 2))));
+    ASSERT_FALSE(board->isLegal(Move(Point(4, 1), Point(4, 3))));
+}
+
+TEST(ChessboardSpecialMoves, NoCastlingThroughCheck)
+{
+    auto board = Bench::loadPosition("4k3/8/8/8/8/8/5r2/4K2R w K - 0 1");
+    ASSERT_FALSE(board->isLegal(Move(Point(4, 0), Point(6, 0))));
+    ASSERT_FALSE(board->isLegal(Move(Point(7, 0), Point(4, 0))));
+}
+
+TEST(ChessboardMoveGenerator, CapturesComeFirst)
+{
+    auto board = Bench::loadPosition("4k3/8/8/3p4/4P3/8/8/R3K3 w - - 0 1");
+    auto generator = board->generateMoves(Whites);
+
+    Move move;
+    ASSERT_TRUE(generator.next(move));
+    ASSERT_EQ(move, Move(Point(4, 3), Point(3, 4)));
+    ASSERT_EQ(generator.getStage(), MoveGenerator::Captures);
+
+    size_t count = 1;
+    while (generator.next(move))
+        ++count;
+    ASSERT_EQ(count, board->listMoves(Whites).size());
+    ASSERT_EQ(generator.getStage(), MoveGenerator::Done);
+}
+
+TEST(ChessboardMoveGenerator, HasAnyLegalMove)
+{
+    Chessboard c;
+    c.initialize();
+    ASSERT_TRUE(c.hasAnyLegalMove(Whites));
+    ASSERT_TRUE(c.hasAnyLegalMove(Blacks));
+
+    auto mate = Bench::loadPosition("7k/6Q1/6K1/8/8/8/8/8 b - - 0 1");
+    ASSERT_FALSE(mate->hasAnyLegalMove(Blacks));
+    ASSERT_TRUE(mate->hasAnyLegalMove(Whites));
+
+    auto stalemate = Bench::loadPosition("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    ASSERT_FALSE(stalemate->hasAnyLegalMove(Blacks));
+}
+
+TEST(ChessboardAttacks, AttackersToSquare)
+{
+    auto board = Bench::loadPosition("4k3/8/8/3p4/8/2N5/B7/R3K3 w - - 0 1");
+    const int d5 = Attacks::square(3, 4);
+    // knight from c3, bishop from a2 through the empty diagonal
+    ASSERT_EQ(board->attackersTo(d5), Attacks::bit(2, 2) | Attacks::bit(0, 1));
+    ASSERT_TRUE(board->isAttacked(d5, Whites));
+    ASSERT_FALSE(board->isAttacked(d5, Blacks));
+
+    // attackers of both sides are reported
+    const int e4 = Attacks::square(4, 3);
+    ASSERT_EQ(board->attackersTo(e4), Attacks::bit(3, 4) | Attacks::bit(2, 2));
+    ASSERT_TRUE(board->isAttacked(e4, Blacks));
+
+    // the king blocks the rook's way further along the rank
+    ASSERT_EQ(board->attackersTo(Attacks::square(5, 0)), Attacks::bit(4, 0));
+    ASSERT_THROW(board->isAttacked(64, Whites), std::invalid_argument);
+}
+
+TEST(ChessboardAttacks, CastlingThroughAttackedSquare)
+{
+    auto board = Bench::loadPosition("4k3/8/8/8/8/8/5r2/4K2R w K - 0 1");
+    ASSERT_TRUE(board->isAttacked(Attacks::square(5, 0), Blacks));
+    ASSERT_FALSE(board->isLegal(Move(Point(4, 0), Point(6, 0))));
+    ASSERT_FALSE(board->isLegal(Move(Point(7, 0), Point(4, 0))));
+
+    auto free = Bench::loadPosition("4k3/8/8/8/8/8/8/4K2R w K - 0 1");
+    ASSERT_TRUE(free->isLegal(Move(Point(4, 0), Point(6, 0))));
+}
+
@@ -0,0 +1,63 @@
+#include <Chessboard.h>
+#include <Fen.h>
+#include <Point.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+#include "testHelpers.h"
+
+using namespace std;
+
+TEST(ChessboardFen, StartPosition)
+{
+    Chessboard c;
+    c.initialize();
+    ASSERT_EQ(c.toFen(), Fen::StartPosition);
+    ASSERT_EQ(Fen::parse(Fen::StartPosition), c.snapshot());
+
+    play(c, 4, 1, 4, 3);
+    ASSERT_EQ(c.toFen(), "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+    play(c, 6, 7, 5, 5);
+    ASSERT_EQ(c.toFen(), "rnbqkb1r/pppppppp/5n2/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 1 2");
+}
+
+TEST(ChessboardFen, RoundTrip)
+{
+    const char* positions[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3qbrk/6p1/2b2pPp/p3pP1Q/PpPpP2P/3P1B2/2PB3K/R5R1 w - - 16 42",
+        "8/5bk1/8/2Pp4/8/1K6/8/8 w - d6 0 1",
+        "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 37",
+        "1r2k2r/8/8/8/8/8/8/R3K2R w KQk - 0 1",
+    };
+    for (const auto* fen : positions) {
+        Chessboard c;
+        c.loadFen(fen);
+        ASSERT_EQ(c.toFen(), fen);
+        ASSERT_EQ(Fen::write(Fen::parse(fen)), fen);
+    }
+
+    // clocks and en passant are optional
+    ASSERT_EQ(Fen::write(Fen::parse("4k3/8/8/8/8/8/8/4K2R w K")), "4k3/8/8/8/8/8/8/4K2R w K - 0 1");
+    ASSERT_EQ(Fen::parse("4k3/8/8/8/8/8/8/4K3 b - - 3 10").getPly(), 19u);
+}
+
+TEST(ChessboardFen, RejectsBrokenText)
+{
+    const char* broken[] = {
+        "",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1",
+        "rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkz - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e3 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - x 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 7",
+        "rnbq1bnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQ - 0 1",
+    };
+    for (const auto* fen : broken)
+        ASSERT_THROW(Fen::parse(fen), std::invalid_argument) << fen;
+}
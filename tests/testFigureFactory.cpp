@@ -27,7 +27,7 @@ TEST(FigureFactory, CorrectWhitePawnPlacement)
         ASSERT_EQ(i->getMovesCount(), 0);
         ASSERT_EQ(i->getPlayer(), FigurePlayer::Whites);
         ASSERT_EQ(i->getType(), FigureType::Pawn);
-        ASSERT_EQ(i->getKilledBy(), nullptr);
+        ASSERT_TRUE(i->isAlive());
         x++;
     }
 }
@@ -43,7 +43,7 @@ TEST(FigureFactory, CorrectBlackPawnPlacement)
         ASSERT_EQ(i->getMovesCount(), 0);
         ASSERT_EQ(i->getPlayer(), FigurePlayer::Blacks);
         ASSERT_EQ(i->getType(), FigureType::Pawn);
-        ASSERT_EQ(i->getKilledBy(), nullptr);
+        ASSERT_TRUE(i->isAlive());
         x++;
     }
 }
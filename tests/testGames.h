@@ -0,0 +1,20 @@
+#pragma once
+
+/// Morphy's opera game with a comment, a variation, a NAG and a rest of line comment
+inline const char* const operaGame = R"([Event "Paris"]
+[Site "Paris FRA"]
+[Date "1858.??.??"]
+[White "Paul Morphy"]
+[Black "Duke Karl / Count Isouard"]
+[Result "1-0"]
+
+1. e4 e5 2. Nf3 d6 3. d4 Bg4 {This is a weak move already.} 4. dxe5 Bxf3
+5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7 8. Nc3 c6 9. Bg5 b5 $2 (9... Qb4 10. Qxb4
+Bxb4) 10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7 14. Rd1 Qe6
+15. Bxd7+ Nxd7 16. Qb8+ ; the queen goes
+Nxb8 17. Rd8# 1-0
+
+)";
+
+/// the position after the last move of operaGame
+inline const char* const operaFinal = "1n1Rkb1r/p4ppp/4q3/4p1B1/4P3/8/PPP2PPP/2K5 b k - 1 17";
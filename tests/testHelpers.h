@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Chessboard.h"
+#include "Point.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+/// plays a move of the side to move and passes the turn, fails the test if it is refused
+inline void play(
+    Chessboard& c, unsigned int fromX, unsigned int fromY, unsigned int toX, unsigned int toY)
+{
+    ASSERT_TRUE(c.prepareMove(
+        std::make_shared<Point>(fromX, fromY), std::make_shared<Point>(toX, toY)));
+    c.setTurn(!c.getWhitesTurn());
+}
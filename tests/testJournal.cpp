@@ -0,0 +1,110 @@
+#include <Chessboard.h>
+#include <Journal.h>
+#include <MappedFile.h>
+#include <Move.h>
+#include <Point.h>
+#include <Saver.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "testHelpers.h"
+
+using namespace std;
+
+TEST(ChessboardJournal, ReplaysFromLastCheckpoint)
+{
+    const string fileName = "journalTest.journal";
+    Journal journal(fileName, 3);
+    Chessboard c;
+    c.initialize();
+    journal.start(c);
+
+    const int moves[][4] = {{4, 1, 4, 3}, {4, 6, 4, 4}, {6, 0, 5, 2}, {1, 7, 2, 5}, {5, 0, 2, 3}};
+    for (const auto& m : moves) {
+        play(c, m[0], m[1], m[2], m[3]);
+        journal.append(c);
+    }
+
+    auto loaded = journal.load();
+    ASSERT_EQ(loaded->toFen(), c.toFen());
+    // a checkpoint was written after the third move
+    ASSERT_EQ(loaded->getMoves().size(), 2);
+    ASSERT_EQ(loaded->getMoves(), vector<Move>(c.getMoves().end() - 2, c.getMoves().end()));
+
+    // the whole game skips checkpoints after the first one
+    {
+        MappedFile file(fileName);
+        auto whole = Journal::replay(file.getData(), file.getSize(), true);
+        ASSERT_EQ(whole->toFen(), c.toFen());
+        ASSERT_EQ(whole->getMoves(), c.getMoves());
+    }
+
+    // Saver tells a journal from its own formats
+    ASSERT_EQ(Saver(fileName).loadCheckboard()->toFen(), c.toFen());
+    remove(fileName.c_str());
+}
+
+TEST(ChessboardJournal, IgnoresTornLastRecord)
+{
+    const string fileName = "journalTornTest.journal";
+    Chessboard c;
+    c.initialize();
+    {
+        Journal journal(fileName);
+        journal.start(c);
+        play(c, 3, 1, 3, 3);
+        journal.append(c);
+    }
+    const auto expected = c.toFen();
+    {
+        // a crash in the middle of the next move record
+        ofstream file(fileName, ios::binary | ios::app);
+        file.write("M\x0c", 2);
+    }
+    ASSERT_EQ(Journal(fileName).load()->toFen(), expected);
+
+    // anything but a torn tail is reported
+    Journal(fileName).start(c);
+    {
+        ofstream file(fileName, ios::binary | ios::app);
+        file.write("X\x0c\x1c\x00", 4);
+    }
+    ASSERT_THROW(Journal(fileName).load(), runtime_error);
+    remove(fileName.c_str());
+}
+
+TEST(ChessboardJournal, ReplaysWholeGameEndingOnRecordBoundary)
+{
+    const string fileName = "journalBoundaryTest.journal";
+    Journal journal(fileName, 2);
+    Chessboard c;
+    c.initialize();
+    journal.start(c);
+
+    // the third move ends the file, the fourth is followed by a checkpoint,
+    // either way nothing may be read past the data
+    const int moves[][4] = {{4, 1, 4, 3}, {4, 6, 4, 4}, {6, 0, 5, 2}, {1, 7, 2, 5}};
+    for (const auto& m : moves) {
+        play(c, m[0], m[1], m[2], m[3]);
+        journal.append(c);
+        if (c.getMoves().size() < 3)
+            continue;
+
+        vector<uint8_t> data;
+        {
+            MappedFile file(fileName);
+            data.assign(file.getData(), file.getData() + file.getSize());
+        }
+        auto whole = Journal::replay(data.data(), data.size(), true);
+        ASSERT_EQ(whole->toFen(), c.toFen());
+        ASSERT_EQ(whole->getMoves(), c.getMoves());
+    }
+    remove(fileName.c_str());
+}
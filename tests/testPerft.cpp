@@ -0,0 +1,80 @@
+#include <Bench.h>
+#include <Chessboard.h>
+#include <Move.h>
+#include <Point.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// published reference counts, see chessprogramming wiki "Perft Results"
+struct PerftCase {
+    std::string fen;
+    std::vector<std::uint64_t> nodes; // by depth starting from 1
+};
+
+class Perft : public ::testing::TestWithParam<PerftCase> {
+};
+
+namespace {
+
+// same walk as Bench::perft, but over the lazy generator
+std::uint64_t generatorPerft(const PChessboard& board, unsigned int depth)
+{
+    const auto side = board->getWhitesTurn() ? Whites : Blacks;
+    std::uint64_t nodes = 0;
+    for (const auto& move : board->generateMoves(side)) {
+        if (depth == 1) {
+            ++nodes;
+            continue;
+        }
+        auto child = board->clone();
+        child->prepareMove(std::make_shared<Point>(move.getFrom()),
+                           std::make_shared<Point>(move.getTo()), move.getPromotion());
+        child->setTurn(!board->getWhitesTurn());
+        nodes += generatorPerft(child, depth - 1);
+    }
+    return nodes;
+}
+
+} // namespace
+
+TEST_P(Perft, MatchesReference)
+{
+    const auto& param = GetParam();
+    auto board = Bench::loadPosition(param.fen);
+    for (unsigned int depth = 1; depth <= param.nodes.size(); ++depth)
+        ASSERT_EQ(Bench::perft(board, depth), param.nodes[depth - 1]) << "depth " << depth;
+}
+
+TEST_P(Perft, GeneratorMatchesReference)
+{
+    const auto& param = GetParam();
+    auto board = Bench::loadPosition(param.fen);
+    const unsigned int depth = param.nodes.size() > 2 ? 2 : param.nodes.size();
+    ASSERT_EQ(generatorPerft(board, depth), param.nodes[depth - 1]) << "depth " << depth;
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Reference,
+    Perft,
+    ::testing::Values(
+        PerftCase{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", {20, 400, 8902}},
+        PerftCase{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                  {48, 2039, 97862}},
+        PerftCase{"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+                  {14, 191, 2812, 43238, 674624}},
+        PerftCase{"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+                  {6, 264, 9467}},
+        PerftCase{"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", {44, 1486, 62379}},
+        PerftCase{"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+                  {46, 2079, 89890}},
+        // en passant and promotion corner cases
+        PerftCase{"8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", {15, 126, 1928}},
+        PerftCase{"8/5bk1/8/2Pp4/8/1K6/8/8 w - d6 0 1", {8, 104, 736}},
+        // en passant takes the pawn giving check
+        PerftCase{"8/8/8/2k5/2pP4/8/B7/4K3 b - d3 0 3", {8}},
+        PerftCase{"8/P1k5/K7/8/8/8/8/8 w - - 0 1", {6, 27, 273}},
+        PerftCase{"n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1", {24, 496, 9483}}));
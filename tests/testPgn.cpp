@@ -0,0 +1,179 @@
+#include <Bench.h>
+#include <Chessboard.h>
+#include <Move.h>
+#include <PgnReader.h>
+#include <PgnWriter.h>
+#include <Point.h>
+#include <San.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "testGames.h"
+
+TEST(San, ResolvesAgainstLegalMoves)
+{
+    auto board = Bench::loadPosition("r3k2r/1P6/8/3pP3/8/1N3N2/8/R3K2R w KQkq d6 0 1");
+
+    ASSERT_EQ(San::parse(*board, "Nbd4"), Move(Point(1, 2), Point(3, 3)));
+    ASSERT_EQ(San::parse(*board, "Nfd4"), Move(Point(5, 2), Point(3, 3)));
+    ASSERT_THROW(San::parse(*board, "Nd4"), std::invalid_argument);
+    ASSERT_EQ(San::parse(*board, "exd6"), Move(Point(4, 4), Point(3, 5)));
+    ASSERT_EQ(San::parse(*board, "e6"), Move(Point(4, 4), Point(4, 5)));
+    ASSERT_EQ(San::parse(*board, "O-O+"), Move(Point(4, 0), Point(6, 0)));
+    ASSERT_EQ(San::parse(*board, "0-0-0"), Move(Point(4, 0), Point(2, 0)));
+    ASSERT_EQ(San::parse(*board, "bxa8=N"), Move(Point(1, 6), Point(0, 7), Knight));
+    ASSERT_EQ(San::parse(*board, "b8Q!"), Move(Point(1, 6), Point(1, 7), Queen));
+    ASSERT_EQ(San::parse(*board, "R1a7"), Move(Point(0, 0), Point(0, 6)));
+    ASSERT_THROW(San::parse(*board, "Ke3"), std::invalid_argument);
+    ASSERT_THROW(San::parse(*board, "Qd1"), std::invalid_argument);
+    ASSERT_THROW(San::parse(*board, "x"), std::invalid_argument);
+}
+
+TEST(PgnReader, ReplaysCommentedGame)
+{
+    unsigned int calls = 0;
+    auto stats = PgnReader().read(operaGame, [&](const PgnGame& game) {
+        ++calls;
+        ASSERT_EQ(game.tag("White"), "Paul Morphy");
+        ASSERT_EQ(game.tag("ECO"), "");
+        ASSERT_EQ(game.result, "1-0");
+        ASSERT_EQ(game.board->getMoves().size(), 33);
+        ASSERT_EQ(game.board->toFen(), operaFinal);
+    });
+
+    ASSERT_EQ(calls, 1);
+    ASSERT_EQ(stats.games, 1);
+    ASSERT_EQ(stats.skipped, 0);
+    ASSERT_EQ(stats.moves, 33);
+    ASSERT_EQ(stats.bytes, std::string(operaGame).size());
+}
+
+TEST(PgnReader, StartsFromFenTagAndSkipsBrokenGames)
+{
+    const std::string text = "[Event \"broken\"]\n\n1. e4 e5 2. Ke3 *\n\n"
+                             "[SetUp \"1\"]\n[FEN \"4k3/8/8/8/8/8/8/4K2R w K - 0 1\"]\n\n"
+                             "1. O-O Kd7 2. Rd1+ 1/2-1/2\n";
+    std::string fen;
+    auto stats = PgnReader().read(text, [&](const PgnGame& game) {
+        fen = game.board->toFen();
+        ASSERT_EQ(game.result, "1/2-1/2");
+    });
+
+    ASSERT_EQ(stats.games, 1);
+    ASSERT_EQ(stats.skipped, 1);
+    ASSERT_EQ(fen, "8/3k4/8/8/8/8/8/3R2K1 b - - 3 2");
+}
+
+TEST(PgnReader, SplitsWorkAtGameBoundaries)
+{
+    std::string text;
+    for (int i = 0; i < 24; ++i)
+        text += operaGame;
+
+    std::atomic<unsigned int> finals{0};
+    auto stats = PgnReader(4).read(text, [&](const PgnGame& game) {
+        if (game.board->toFen() == operaFinal)
+            ++finals;
+    });
+
+    ASSERT_EQ(stats.games, 24);
+    ASSERT_EQ(stats.skipped, 0);
+    ASSERT_EQ(finals, 24);
+}
+
+TEST(San, WritesDisambiguationAndCaptures)
+{
+    auto board = Bench::loadPosition("r3k2r/1P6/8/3pP3/8/1N3N2/8/R3K2R w KQkq d6 0 1");
+    auto san = [&](const Move& move) {
+        std::string out;
+        San::write(*board, move, out);
+        return out;
+    };
+
+    ASSERT_EQ(san(Move(Point(1, 2), Point(3, 3))), "Nbd4");
+    ASSERT_EQ(san(Move(Point(5, 2), Point(6, 4))), "Ng5");
+    ASSERT_EQ(san(Move(Point(4, 4), Point(3, 5))), "exd6");
+    ASSERT_EQ(san(Move(Point(4, 4), Point(4, 5))), "e6");
+    ASSERT_EQ(san(Move(Point(4, 0), Point(2, 0))), "O-O-O");
+    ASSERT_EQ(san(Move(Point(1, 6), Point(0, 7), Knight)), "bxa8=N");
+    ASSERT_EQ(san(Move(Point(0, 0), Point(0, 6))), "Ra7");
+    ASSERT_EQ(san(Move(Point(0, 0), Point(0, 7))), "Rxa8");
+
+    auto queens = Bench::loadPosition("4k3/8/8/8/Q2Q4/8/8/Q3K3 w - - 0 1");
+    std::string out;
+    San::write(*queens, Move(Point(0, 3), Point(3, 0)), out);
+    ASSERT_EQ(out, "Qa4d1");
+}
+
+TEST(PgnWriter, WritesWhatReaderReads)
+{
+    PgnWriter writer;
+    PgnReader().read(operaGame, [&](const PgnGame& game) {
+        writer.write(*game.board, game.tags);
+    });
+
+    const auto& text = writer.getBuffer();
+    ASSERT_NE(text.find("[White \"Paul Morphy\"]\n"), std::string::npos);
+    ASSERT_NE(text.find("[Result \"1-0\"]\n"), std::string::npos);
+    ASSERT_EQ(text.find("[FEN"), std::string::npos);
+    ASSERT_NE(text.find("11. Bxb5+ Nbd7 12. O-O-O Rd8"), std::string::npos);
+    ASSERT_NE(text.find("17. Rd8# 1-0\n"), std::string::npos);
+
+    std::istringstream lines(text);
+    for (std::string line; std::getline(lines, line);)
+        ASSERT_LE(line.size(), 80) << line;
+
+    unsigned int games = 0;
+    PgnReader().read(text, [&](const PgnGame& game) {
+        ++games;
+        ASSERT_EQ(game.board->toFen(), operaFinal);
+        ASSERT_EQ(game.result, "1-0");
+    });
+    ASSERT_EQ(games, 1);
+}
+
+TEST(PgnWriter, KeepsStartPositionAndBuffer)
+{
+    auto board = Bench::loadPosition("4k3/8/8/8/8/8/8/4K2R b K - 0 30");
+    ASSERT_TRUE(board->prepareMove(std::make_shared<Point>(4, 7), std::make_shared<Point>(3, 7)));
+    board->setTurn(true);
+
+    PgnWriter writer;
+    writer.write(*board);
+    const auto size = writer.getBuffer().size();
+    ASSERT_NE(writer.getBuffer().find("[FEN \"4k3/8/8/8/8/8/8/4K2R b K - 0 30\"]"),
+              std::string::npos);
+    ASSERT_NE(writer.getBuffer().find("30... Kd8 *"), std::string::npos);
+
+    writer.write(*board, {{"Event", "Second"}}, "1/2-1/2");
+    ASSERT_GT(writer.getBuffer().size(), size);
+
+    std::ostringstream out;
+    writer.flush(out);
+    ASSERT_TRUE(writer.getBuffer().empty());
+    ASSERT_NE(out.str().find("[Event \"Second\"]"), std::string::npos);
+    ASSERT_NE(out.str().find("30... Kd8 1/2-1/2"), std::string::npos);
+}
+
+TEST(PgnWriter, WritesCastlingWithRookOntoKing)
+{
+    auto board = Bench::loadPosition("4k3/8/8/8/8/8/8/4K2R w K - 0 1");
+    ASSERT_TRUE(board->prepareMove(std::make_shared<Point>(7, 0), std::make_shared<Point>(4, 0)));
+    board->setTurn(false);
+
+    PgnWriter writer;
+    writer.write(*board);
+    ASSERT_NE(writer.getBuffer().find("1. O-O *"), std::string::npos);
+
+    std::string fen;
+    auto stats = PgnReader().read(writer.getBuffer(), [&](const PgnGame& game) {
+        fen = game.board->toFen();
+    });
+    ASSERT_EQ(stats.games, 1);
+    ASSERT_EQ(stats.skipped, 0);
+    ASSERT_EQ(fen, board->toFen());
+}
@@ -0,0 +1,140 @@
+#include <Bench.h>
+#include <Bytes.h>
+#include <Chessboard.h>
+#include <Move.h>
+#include <Point.h>
+#include <PolyglotBook.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST(PolyglotBook, KeysMatchPolyglotExamples)
+{
+    // positions and keys given with the book format of Polyglot
+    const std::pair<const char*, std::uint64_t> examples[] = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 0x463b96181691fc9c},
+        {"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", 0x823c9b50fd114196},
+        {"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", 0x0756b94461c50fb0},
+        {"rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2", 0x662fafb965db29d4},
+        {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 0x22a48b5a8e47ff78},
+        {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3", 0x652a607ca3f242c1},
+        {"rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4", 0x00fdd303c946bdd9},
+        {"rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3", 0x3c8123ea7b067637},
+        {"rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4", 0x5c3f9b829b279560},
+    };
+    const PolyglotKeys keys;
+    for (const auto& example : examples)
+        ASSERT_EQ(keys.hash(*Bench::loadPosition(example.first)), example.second) << example.first;
+}
+
+TEST(PolyglotBook, EncodesMovesAndKeysLikePolyglot)
+{
+    auto board = Bench::loadPosition("r3k2r/1P6/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    const auto snapshot = board->snapshot();
+
+    // castling is the king taking its own rook
+    const Move castling(Point(4, 0), Point(6, 0));
+    ASSERT_EQ(PolyglotKeys::encode(snapshot, castling), 7 | 4 << 6);
+    ASSERT_EQ(PolyglotKeys::decode(snapshot, 7 | 4 << 6), castling);
+    const Move longCastling(Point(4, 0), Point(2, 0));
+    ASSERT_EQ(PolyglotKeys::decode(snapshot, PolyglotKeys::encode(snapshot, longCastling)),
+              longCastling);
+    const Move promotion(Point(1, 6), Point(1, 7), Knight);
+    ASSERT_EQ(PolyglotKeys::encode(snapshot, promotion), 1 | 7 << 3 | 1 << 6 | 6 << 9 | 1 << 12);
+    ASSERT_EQ(PolyglotKeys::decode(snapshot, PolyglotKeys::encode(snapshot, promotion)), promotion);
+    ASSERT_EQ(PolyglotKeys::encode(snapshot, Move(Point(0, 0), Point(0, 5))), 5 << 3);
+
+    // en passant only counts when a pawn is there to take
+    const PolyglotKeys keys;
+    ASSERT_NE(keys.hash(*Bench::loadPosition("4k3/8/8/8/3pP3/8/8/4K3 b - e3 0 1")),
+              keys.hash(*Bench::loadPosition("4k3/8/8/8/3pP3/8/8/4K3 b - - 0 1")));
+    ASSERT_EQ(keys.hash(*Bench::loadPosition("4k3/8/8/8/4P3/8/8/4K3 b - e3 0 1")),
+              keys.hash(*Bench::loadPosition("4k3/8/8/8/4P3/8/8/4K3 b - - 0 1")));
+    ASSERT_NE(keys.hash(*board),
+              keys.hash(*Bench::loadPosition("r3k2r/1P6/8/8/8/8/8/R3K2R w Kkq - 0 1")));
+
+    const std::string fileName = "polyglotKeysTest.txt";
+    {
+        std::ofstream file(fileName);
+        for (unsigned int i = 0; i < PolyglotKeys::Size; ++i)
+            file << "U64(0x" << std::hex << i * 0x9E3779B97F4A7C15ull << "),\n";
+    }
+    ASSERT_NE(PolyglotKeys::load(fileName).hash(*board), keys.hash(*board));
+    std::ofstream(fileName) << "0x1, 0x2";
+    ASSERT_THROW(PolyglotKeys::load(fileName), std::runtime_error);
+    std::remove(fileName.c_str());
+}
+
+TEST(PolyglotBook, PicksLegalMovesByWeight)
+{
+    Chessboard start;
+    start.initialize();
+    const PolyglotKeys keys;
+    const auto key = keys.hash(start);
+    const auto snapshot = start.snapshot();
+    auto code = [&](int fx, int fy, int tx, int ty) {
+        return PolyglotKeys::encode(snapshot, Move(Point(fx, fy), Point(tx, ty)));
+    };
+
+    struct Entry {
+        std::uint64_t key;
+        std::uint16_t move, weight;
+    };
+    std::vector<Entry> entries = {{key, code(4, 1, 4, 3), 3},
+                                  {key, code(3, 1, 3, 3), 1},
+                                  {key, code(0, 1, 0, 2), 0},
+                                  // cannot be played, so it is never found
+                                  {key, code(4, 1, 4, 4), 100},
+                                  {key - 1, code(6, 0, 5, 2), 1},
+                                  {key + 1, code(1, 0, 2, 2), 1}};
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+    const std::string fileName = "polyglotBookTest.bin";
+    {
+        std::ofstream file(fileName, std::ios::binary);
+        for (const auto& entry : entries) {
+            std::uint8_t bytes[PolyglotBook::EntrySize] = {};
+            Bytes::storeBig(bytes, entry.key);
+            Bytes::storeBig(bytes + 8, entry.move);
+            Bytes::storeBig(bytes + 10, entry.weight);
+            file.write((const char*)bytes, sizeof(bytes));
+        }
+    }
+
+    {
+        PolyglotBook book(fileName, keys, PolyglotBook::Best);
+        ASSERT_EQ(book.size(), entries.size());
+        const auto found = book.find(start);
+        ASSERT_EQ(found.size(), 3);
+        ASSERT_EQ(found[0].move, Move(Point(4, 1), Point(4, 3)));
+        ASSERT_EQ(found[1].move, Move(Point(3, 1), Point(3, 3)));
+        ASSERT_EQ(found[2].weight, 0);
+
+        Move move;
+        ASSERT_TRUE(book.pick(start, move));
+        ASSERT_EQ(move, Move(Point(4, 1), Point(4, 3)));
+        ASSERT_FALSE(book.pick(*Bench::loadPosition("4k3/8/8/8/8/8/8/4K3 w - - 0 1"), move));
+
+        PolyglotBook weighted(fileName, keys);
+        unsigned int kingsPawn = 0;
+        for (int i = 0; i < 200; ++i) {
+            ASSERT_TRUE(weighted.pick(start, move));
+            ASSERT_NE(move, Move(Point(0, 1), Point(0, 2)));
+            kingsPawn += move == Move(Point(4, 1), Point(4, 3));
+        }
+        ASSERT_GT(kingsPawn, 100);
+        ASSERT_LT(kingsPawn, 200);
+    }
+
+    std::ofstream(fileName, std::ios::binary | std::ios::app) << "torn";
+    ASSERT_THROW(PolyglotBook{fileName}, std::runtime_error);
+    std::remove(fileName.c_str());
+}
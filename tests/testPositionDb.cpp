@@ -0,0 +1,91 @@
+#include <Bench.h>
+#include <Chessboard.h>
+#include <Move.h>
+#include <PgnReader.h>
+#include <Point.h>
+#include <PositionDb.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "testGames.h"
+
+TEST(PositionDb, CountsResultsAndMovesOfPositions)
+{
+    const std::string text = std::string(operaGame)
+        + "[Result \"1/2-1/2\"]\n\n1. e4 e5 2. Nf3 1/2-1/2\n\n"
+        + "[Result \"*\"]\n\n1. d4 *\n";
+    PositionDbBuilder builder;
+    unsigned int added = 0;
+    PgnReader().read(text, [&](const PgnGame& game) {
+        added += builder.addGame(*game.board, game.result);
+    });
+    ASSERT_EQ(added, 2);
+    // 34 positions of the opera game and 4 of the draw
+    ASSERT_EQ(builder.size(), 38);
+
+    const std::string fileName = "positionDbTest.db";
+    builder.write(fileName);
+    {
+        PositionDb db(fileName);
+        // the draw never left the opera game
+        ASSERT_EQ(db.size(), 34);
+
+        PositionStats stats;
+        Chessboard start;
+        start.initialize();
+        ASSERT_TRUE(db.find(start, stats));
+        ASSERT_EQ(stats.games(), 2);
+        ASSERT_EQ(stats.whitesWon, 1);
+        ASSERT_EQ(stats.draws, 1);
+        ASSERT_EQ(stats.blacksWon, 0);
+        ASSERT_EQ(stats.moves.size(), 1);
+        ASSERT_EQ(stats.moves[0].first, Move(Point(4, 1), Point(4, 3)));
+        ASSERT_EQ(stats.moves[0].second, 2);
+
+        // the draw stopped here, so only the opera game has a move
+        auto board
+            = Bench::loadPosition("rnbqkbnr/pppp1ppp/8/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R b KQkq - 1 2");
+        ASSERT_TRUE(db.find(*board, stats));
+        ASSERT_EQ(stats.games(), 2);
+        ASSERT_EQ(stats.moves.size(), 1);
+        ASSERT_EQ(stats.moves[0].first, Move(Point(3, 6), Point(3, 5)));
+
+        ASSERT_TRUE(db.find(*Bench::loadPosition(operaFinal), stats));
+        ASSERT_EQ(stats.games(), 1);
+        ASSERT_TRUE(stats.moves.empty());
+
+        ASSERT_FALSE(db.find(*Bench::loadPosition("4k3/8/8/8/8/8/8/4K3 w - - 0 1"), stats));
+    }
+
+    std::ofstream(fileName, std::ios::binary) << "CHSD broken";
+    ASSERT_THROW(PositionDb{fileName}, std::runtime_error);
+    std::remove(fileName.c_str());
+}
+
+TEST(PositionDb, CountsRepeatedPositionOncePerGame)
+{
+    PositionDbBuilder builder;
+    PgnReader().read("[Result \"1/2-1/2\"]\n\n1. Nf3 Nf6 2. Ng1 Ng8 3. Nf3 Nf6 4. Ng1 Ng8 1/2-1/2\n",
+                     [&](const PgnGame& game) { builder.addGame(*game.board, game.result); });
+    // the start position and three after it, each met again later
+    ASSERT_EQ(builder.size(), 4);
+
+    const std::string fileName = "positionDbRepeatTest.db";
+    builder.write(fileName);
+    {
+        PositionDb db(fileName);
+        PositionStats stats;
+        Chessboard start;
+        start.initialize();
+        ASSERT_TRUE(db.find(start, stats));
+        ASSERT_EQ(stats.games(), 1);
+        ASSERT_EQ(stats.draws, 1);
+        ASSERT_EQ(stats.moves.size(), 1);
+        ASSERT_EQ(stats.moves[0].second, 1);
+    }
+    std::remove(fileName.c_str());
+}
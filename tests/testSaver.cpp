@@ -0,0 +1,82 @@
+#include <Bench.h>
+#include <Chessboard.h>
+#include <Fen.h>
+#include <Move.h>
+#include <Point.h>
+#include <Saver.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "testHelpers.h"
+
+using namespace std;
+
+TEST(ChessboardBinarySave, KeepsPositionAndMoves)
+{
+    Chessboard c;
+    c.initialize();
+    play(c, 4, 1, 4, 3);
+    play(c, 3, 6, 3, 4);
+    play(c, 4, 3, 3, 4);
+    play(c, 2, 6, 2, 4);
+    auto board = c.clone();
+    board->setTurn(c.getWhitesTurn());
+
+    const string fileName = "binarySaveTest.bin";
+    Saver(fileName, Saver::Binary).saveCheckboard(board);
+    // the text saver detects the format by itself
+    auto loaded = Saver(fileName).loadCheckboard();
+    remove(fileName.c_str());
+
+    ASSERT_EQ(loaded->snapshot(), board->snapshot());
+    ASSERT_EQ(loaded->toFen(), "rnbqkbnr/pp2pppp/8/2pP4/8/8/PPPP1PPP/RNBQKBNR w KQkq c6 0 3");
+    ASSERT_EQ(loaded->getMoves(), board->getMoves());
+    ASSERT_EQ(loaded->getMoves().size(), 4);
+    ASSERT_EQ(loaded->getStartPosition(), Fen::parse(Fen::StartPosition));
+    ASSERT_TRUE(loaded->isLegal(Move(Point(3, 4), Point(2, 5))));
+}
+
+TEST(ChessboardBinarySave, KeepsPromotions)
+{
+    auto board = Bench::loadPosition("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+    ASSERT_TRUE(board->prepareMove(make_shared<Point>(1, 6), make_shared<Point>(1, 7), Knight));
+
+    const string fileName = "binaryPromotionTest.bin";
+    Saver(fileName, Saver::Binary).saveCheckboard(board);
+    auto loaded = Saver(fileName, Saver::Binary).loadCheckboard();
+    remove(fileName.c_str());
+
+    ASSERT_EQ(loaded->getMoves(), vector<Move>{Move(Point(1, 6), Point(1, 7), Knight)});
+    ASSERT_TRUE(loaded->at(make_shared<Point>(1, 7))->isKnight());
+    ASSERT_EQ(loaded->getDeadFigures().size(), 1);
+}
+
+TEST(ChessboardBinarySave, RejectsTruncatedFile)
+{
+    Chessboard c;
+    c.initialize();
+    play(c, 6, 0, 5, 2);
+    auto board = c.clone();
+
+    const string fileName = "binaryTruncatedTest.bin";
+    Saver(fileName, Saver::Binary).saveCheckboard(board);
+    string data;
+    {
+        ifstream file(fileName, ios::binary);
+        data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+    {
+        ofstream file(fileName, ios::binary);
+        file.write(data.data(), data.size() - 1);
+    }
+    ASSERT_THROW(Saver(fileName).loadCheckboard(), std::runtime_error);
+    remove(fileName.c_str());
+    ASSERT_THROW(Saver(fileName).loadCheckboard(), std::runtime_error);
+}
@@ -0,0 +1,149 @@
+#include <Bench.h>
+#include <Chessboard.h>
+#include <Move.h>
+#include <Point.h>
+#include <Search.h>
+#include <Tablebase.h>
+#include <TimeManager.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+const string tablebaseDirectory = "tablebaseTest";
+
+/// tables are solved once for the whole file, it takes a second or so
+class TablebaseTest : public ::testing::Test {
+protected:
+    static TablebaseGenerator generator;
+    static shared_ptr<Tablebase> tablebase;
+
+    static void SetUpTestSuite()
+    {
+        filesystem::create_directory(tablebaseDirectory);
+        for (const auto figure : {Queen, Rook, Pawn})
+            generator.write(figure, tablebaseDirectory + "/" + Tablebase::fileName(figure));
+        tablebase = make_shared<Tablebase>(tablebaseDirectory);
+    }
+
+    static void TearDownTestSuite()
+    {
+        tablebase = nullptr;
+        filesystem::remove_all(tablebaseDirectory);
+    }
+
+    static TablebaseResult probe(const string& fen)
+    {
+        TablebaseResult result;
+        if (!tablebase->probe(*Bench::loadPosition(fen), result))
+            throw invalid_argument("Position is not in tables: " + fen);
+        return result;
+    }
+};
+
+TablebaseGenerator TablebaseTest::generator(2);
+shared_ptr<Tablebase> TablebaseTest::tablebase;
+
+} // namespace
+
+TEST_F(TablebaseTest, FindsLongestMates)
+{
+    // the longest mates are 10 moves with a queen and 16 with a rook,
+    // positions of the side with the figure to move come first
+    auto longest = [](const vector<uint8_t>& values) {
+        unsigned int plies = 0;
+        for (size_t i = 0; i < TablebaseIndex::PositionCount / 2; ++i)
+            if (values[i] != TablebaseIndex::Invalid && values[i] != TablebaseIndex::Draw)
+                plies = max(plies, values[i] - 1u);
+        return plies;
+    };
+    ASSERT_EQ(longest(generator.solve(Queen)), 19);
+    ASSERT_EQ(longest(generator.solve(Rook)), 31);
+    ASSERT_THROW(generator.solve(Knight), invalid_argument);
+}
+
+TEST_F(TablebaseTest, FilesKeepEveryPossiblePosition)
+{
+    for (const auto figure : {Queen, Rook, Pawn}) {
+        ASSERT_TRUE(tablebase->has(figure));
+        const auto& values = generator.solve(figure);
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i] != TablebaseIndex::Invalid) {
+                ASSERT_EQ(tablebase->value(figure, i), values[i]) << i;
+            }
+        }
+    }
+    ASSERT_FALSE(tablebase->has(Bishop));
+}
+
+TEST_F(TablebaseTest, ProbesEitherSide)
+{
+    auto mate = probe("k7/8/1K6/8/8/8/8/7Q w - - 0 1");
+    ASSERT_EQ(mate.wdl, TablebaseResult::Win);
+    ASSERT_EQ(mate.plies, 1);
+    mate = probe("K7/8/1k6/8/8/8/8/7q b - - 0 1");
+    ASSERT_EQ(mate.wdl, TablebaseResult::Win);
+    ASSERT_EQ(mate.plies, 1);
+    ASSERT_EQ(probe("k7/8/1K6/8/8/8/8/7q b - - 0 1").wdl, TablebaseResult::Win);
+
+    // king in front of its pawn on the sixth rank wins whoever moves
+    ASSERT_EQ(probe("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1").wdl, TablebaseResult::Win);
+    ASSERT_EQ(probe("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1").wdl, TablebaseResult::Loss);
+    ASSERT_EQ(probe("8/8/8/8/4p3/4k3/8/4K3 b - - 0 1").wdl, TablebaseResult::Win);
+    // a rook pawn does not get past the king in its corner
+    ASSERT_EQ(probe("7k/8/8/7P/8/8/8/6K1 w - - 0 1").wdl, TablebaseResult::Draw);
+    // the rook hangs
+    ASSERT_EQ(probe("8/8/8/8/8/8/2k5/1R2K3 b - - 0 1").wdl, TablebaseResult::Draw);
+
+    TablebaseResult result;
+    ASSERT_FALSE(tablebase->probe(*Bench::loadPosition("4k3/8/8/8/8/8/8/4K2R w K - 0 1"), result));
+    ASSERT_FALSE(tablebase->probe(*Bench::loadPosition("4k3/8/8/8/8/8/8/3BK2R w - - 0 1"), result));
+    ASSERT_FALSE(tablebase->probe(*Bench::loadPosition("4k3/8/8/8/8/8/8/3BK3 w - - 0 1"), result));
+}
+
+TEST_F(TablebaseTest, BestMovesMateInTime)
+{
+    for (const auto* fen : {"8/8/3k4/8/8/8/8/R3K3 w - - 0 1", "4k3/8/4K3/4P3/8/8/8/8 w - - 0 1"}) {
+        auto board = Bench::loadPosition(fen);
+        auto result = probe(fen);
+        ASSERT_EQ(result.wdl, TablebaseResult::Win) << fen;
+
+        for (auto plies = result.plies; plies > 0; --plies) {
+            Move move;
+            ASSERT_TRUE(tablebase->bestMove(*board, move));
+            ASSERT_TRUE(board->prepareMove(make_shared<Point>(move.getFrom()),
+                                           make_shared<Point>(move.getTo()), move.getPromotion()));
+            board->setTurn(!board->getWhitesTurn());
+            // the mate may go on through a promotion, out of the table probed at first
+            if (plies > 1) {
+                ASSERT_EQ(tablebase->probe(*board, result) ? result.plies : 0, plies - 1) << fen;
+            }
+        }
+        const auto side = board->getWhitesTurn() ? Whites : Blacks;
+        ASSERT_FALSE(board->hasAnyLegalMove(side)) << fen;
+        ASSERT_TRUE(board->isInCheck(side)) << fen;
+    }
+}
+
+TEST_F(TablebaseTest, SearchScoresTablesExactly)
+{
+    auto board = Bench::loadPosition("k7/8/1K6/8/8/8/8/7Q w - - 0 1");
+    auto tm = make_shared<TimeManager>();
+    tm->start(chrono::seconds(100));
+    Search search(tm, tablebase);
+
+    auto move = search.think(board, 1);
+
+    ASSERT_EQ(search.getScore(), Search::MateScore - 1);
+    auto child = board->clone();
+    ASSERT_TRUE(
+        child->prepareMove(make_shared<Point>(move.getFrom()), make_shared<Point>(move.getTo())));
+    ASSERT_FALSE(child->hasAnyLegalMove(Blacks));
+}
@@ -0,0 +1,103 @@
+
+#include <Bench.h>
+#include <GameClock.h>
+#include <Move.h>
+#include <Point.h>
+#include <Search.h>
+#include <TimeManager.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+
+using namespace std;
+using namespace std::chrono;
+
+TEST(GameClock, IncrementIsAddedAfterMove)
+{
+    GameClock clock(seconds(60), seconds(2));
+    clock.start(Whites);
+    clock.stop();
+
+    ASSERT_GT(clock.getRemaining(Whites), seconds(61));
+    ASSERT_EQ(clock.getRemaining(Blacks), seconds(60));
+}
+
+TEST(GameClock, RefillsAfterMovesToGo)
+{
+    GameClock clock(seconds(60), seconds(0), 2);
+    ASSERT_EQ(clock.getMovesToGo(Whites), 2);
+
+    clock.start(Whites);
+    clock.start(Blacks); // switching sides stops whites
+    ASSERT_EQ(clock.getMovesToGo(Whites), 1);
+
+    clock.start(Whites);
+    clock.stop();
+    ASSERT_EQ(clock.getMovesToGo(Whites), 2);
+    ASSERT_GT(clock.getRemaining(Whites), seconds(119));
+}
+
+TEST(TimeManager, HardLimitIsAboveSoftLimit)
+{
+    GameClock clock(seconds(300), seconds(3));
+    TimeManager tm;
+    tm.start(clock, Whites);
+
+    ASSERT_GT(tm.getSoftLimit(), milliseconds(0));
+    ASSERT_GT(tm.getHardLimit(), tm.getSoftLimit());
+    ASSERT_LT(tm.getHardLimit(), clock.getRemaining(Whites));
+}
+
+TEST(TimeManager, StableBestMoveCutsSoftLimit)
+{
+    GameClock clock(seconds(300), seconds(3));
+    TimeManager tm;
+    tm.start(clock, Whites);
+    auto initial = tm.getSoftLimit();
+
+    Move best(Point(4, 1), Point(4, 3));
+    for (int i = 0; i < 5; ++i)
+        tm.iterationFinished(best, 20);
+
+    ASSERT_LT(tm.getSoftLimit(), initial);
+}
+
+TEST(TimeManager, ScoreDropExtendsSoftLimit)
+{
+    GameClock clock(seconds(300), seconds(3));
+    TimeManager tm;
+    tm.start(clock, Whites);
+    auto initial = tm.getSoftLimit();
+
+    Move best(Point(4, 1), Point(4, 3));
+    tm.iterationFinished(best, 50);
+    tm.iterationFinished(best, -150);
+
+    ASSERT_GT(tm.getSoftLimit(), initial);
+    ASSERT_LE(tm.getSoftLimit(), tm.getHardLimit());
+}
+
+TEST(TimeManager, StopFlagIsSeenImmediately)
+{
+    TimeManager tm;
+    tm.start(seconds(100));
+    ASSERT_FALSE(tm.shouldStop(1));
+
+    tm.stop();
+    ASSERT_TRUE(tm.shouldStop(1));
+    ASSERT_FALSE(tm.canStartIteration());
+}
+
+TEST(Search, TakesHangingQueen)
+{
+    auto board = Bench::loadPosition("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1");
+    auto tm = make_shared<TimeManager>();
+    tm->start(seconds(100));
+    Search search(tm);
+
+    auto move = search.think(board, 2);
+
+    ASSERT_EQ(move, Move(Point(3, 0), Point(3, 4)));
+    ASSERT_EQ(search.getDepth(), 2);
+}